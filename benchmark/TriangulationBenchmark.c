@@ -0,0 +1,475 @@
+/**
+ * @file TriangulationBenchmark.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Microbenchmarks of the DrawingUtils geometry kernels: ear
+ * clipping triangulation, centroid fan generation and the orientation
+ * predicates, over generated convex, star, spiral and comb polygons of
+ * 10 to 100k vertices.
+ *
+ * Usage:
+ *    triangulationBenchmark [options]
+ *       -csv <file>        writes the results to a CSV file
+ *       -baseline <file>   compares the results with a CSV written before
+ *       -tolerance <t>     allowed slowdown against the baseline (0.15)
+ *       -maxVertices <n>   largest polygon (100000)
+ *       -budget <s>        time limit of one call, larger polygons of the
+ *                          same kernel and shape are skipped (2)
+ *
+ * Exits with 1 when a result is slower than the baseline beyond the
+ * tolerance, allocates more than it or has a different output count
+ * (triangles, vertices or predicate hits), and with 2 on a bad option
+ * or a baseline that can't be read or has no results.
+ *
+ * Allocations are counted by wrapping malloc and free at link time
+ * (-Wl,--wrap=malloc -Wl,--wrap=free), see the benchmark target of the
+ * Makefile. The frame scratch is created before the measurements, so
+ * the kernels are expected to report none.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "DrawingUtils.h"
+#include "GeometryBuffer.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#define MAX_RESULTS 256
+#define MIN_SAMPLE_TIME 0.05
+
+typedef enum ShapeType {
+    SHAPE_CONVEX,
+    SHAPE_STAR,
+    SHAPE_SPIRAL,
+    SHAPE_COMB
+} ShapeType;
+
+typedef enum KernelType {
+    KERNEL_TRIANGULATE,
+    KERNEL_FAN,
+    KERNEL_IS_CONVEX,
+    KERNEL_IS_TRIANGLE_CCW
+} KernelType;
+
+typedef struct BenchmarkResult {
+    char kernel[32];
+    char shape[32];
+    int vertices;
+    double nsPerVertex;
+    double allocationsPerCall;
+    double bytesPerCall;
+    int outputs;
+    int calls;
+} BenchmarkResult;
+
+static const char *shapeNames[] = { "convex", "star", "spiral", "comb" };
+static const char *kernelNames[] = { "triangulate", "fan", "isConvex", "isTriangleCCW" };
+
+// allocation counting, see the linker flags above
+void *__real_malloc( size_t size );
+void __real_free( void *ptr );
+
+static bool countAllocations = false;
+static long allocations = 0;
+static long allocatedBytes = 0;
+
+void *__wrap_malloc( size_t size ) {
+    if ( countAllocations ) {
+        allocations++;
+        allocatedBytes += (long) size;
+    }
+    return __real_malloc( size );
+}
+
+void __wrap_free( void *ptr ) {
+    __real_free( ptr );
+}
+
+static volatile int sink = 0;
+
+static double now( void ) {
+    struct timespec ts;
+    timespec_get( &ts, TIME_UTC );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double signedArea( const b2Vec2 *points, int n ) {
+    double area = 0.0;
+    for ( int i = 0; i < n; i++ ) {
+        b2Vec2 a = points[i];
+        b2Vec2 b = points[( i + 1 ) % n];
+        area += (double) a.x * b.y - (double) b.x * a.y;
+    }
+    return area / 2.0;
+}
+
+static void reversePoints( b2Vec2 *points, int n ) {
+    for ( int i = 0; i < n / 2; i++ ) {
+        b2Vec2 t = points[i];
+        points[i] = points[n - 1 - i];
+        points[n - 1 - i] = t;
+    }
+}
+
+/**
+ * Generates a polygon with about n vertices, in the same winding as the
+ * chain obstacles drawn with cw = true (angles growing in screen space).
+ * Returns the quantity of vertices generated.
+ */
+static int generateShape( ShapeType shape, int n, b2Vec2 *points ) {
+
+    const float pi = 3.14159265358979f;
+    int count = 0;
+
+    switch ( shape ) {
+
+        case SHAPE_CONVEX:
+            for ( int i = 0; i < n; i++ ) {
+                float a = 2.0f * pi * i / n;
+                points[count++] = (b2Vec2){ 1000.0f * cosf( a ), 1000.0f * sinf( a ) };
+            }
+            break;
+
+        case SHAPE_STAR:
+            n -= n % 2;
+            for ( int i = 0; i < n; i++ ) {
+                float a = 2.0f * pi * i / n;
+                float r = i % 2 == 0 ? 1000.0f : 500.0f;
+                points[count++] = (b2Vec2){ r * cosf( a ), r * sinf( a ) };
+            }
+            break;
+
+        case SHAPE_SPIRAL: {
+            // a thick arm: out along the outer edge, back along the inner
+            int half = n / 2;
+            float turns = 3.0f;
+            float spacing = 100.0f;
+            float width = 50.0f;
+            for ( int i = 0; i < half; i++ ) {
+                float a = 2.0f * pi * turns * i / ( half - 1 );
+                float r = 100.0f + spacing * a / ( 2.0f * pi ) + width;
+                points[count++] = (b2Vec2){ r * cosf( a ), r * sinf( a ) };
+            }
+            for ( int i = half - 1; i >= 0; i-- ) {
+                float a = 2.0f * pi * turns * i / ( half - 1 );
+                float r = 100.0f + spacing * a / ( 2.0f * pi );
+                points[count++] = (b2Vec2){ r * cosf( a ), r * sinf( a ) };
+            }
+            break;
+        }
+
+        case SHAPE_COMB: {
+            // a base with teeth, 4 vertices per tooth plus 2 for the base
+            int teeth = ( n - 2 ) / 4 > 0 ? ( n - 2 ) / 4 : 1;
+            float toothWidth = 10.0f;
+            // the base is wider than the teeth and the gaps alternate
+            // their depth, avoiding collinear runs of vertices
+            points[count++] = (b2Vec2){ -toothWidth, 0.0f };
+            points[count++] = (b2Vec2){ teeth * toothWidth * 2.0f, 0.0f };
+            for ( int t = teeth - 1; t >= 0; t-- ) {
+                float x = t * toothWidth * 2.0f;
+                float y = t % 2 == 0 ? 100.0f : 110.0f;
+                points[count++] = (b2Vec2){ x + toothWidth, y };
+                points[count++] = (b2Vec2){ x + toothWidth, 1000.0f };
+                points[count++] = (b2Vec2){ x, 1000.0f };
+                points[count++] = (b2Vec2){ x, y };
+            }
+            break;
+        }
+
+    }
+
+    // the convex one gives the reference winding
+    if ( signedArea( points, count ) < 0.0 ) {
+        reversePoints( points, count );
+    }
+
+    return count;
+
+}
+
+// triangles, vertices or predicate hits, checks that a faster kernel
+// still does the same work
+static int runKernel( KernelType kernel, const b2Vec2 *points, int n, TriangleB2Vec2 *triangles, GeometryVertex *vertices ) {
+
+    switch ( kernel ) {
+
+        case KERNEL_TRIANGULATE:
+            return triangulatePolygonB2Vec2( points, n, triangles, n, true );
+
+        case KERNEL_FAN:
+            return writeShapeFanB2Vec2( points, n, BLACK, true, vertices );
+
+        case KERNEL_IS_CONVEX: {
+            int convex = 0;
+            for ( int i = 0; i < n; i++ ) {
+                convex += isConvexB2Vec2( points[( i + n - 1 ) % n], points[i], points[( i + 1 ) % n] );
+            }
+            return convex;
+        }
+
+        case KERNEL_IS_TRIANGLE_CCW: {
+            int ccw = 0;
+            b2Vec2 c = points[0];
+            for ( int i = 1; i < n - 1; i++ ) {
+                ccw += isTriangleCCWB2Vec2( c, points[i], points[i + 1] );
+            }
+            return ccw;
+        }
+
+    }
+
+    return 0;
+
+}
+
+static BenchmarkResult measure( KernelType kernel, ShapeType shape, const b2Vec2 *points, int n,
+                                TriangleB2Vec2 *triangles, GeometryVertex *vertices ) {
+
+    // warm up, and the allocations of a single call
+    allocations = 0;
+    allocatedBytes = 0;
+    countAllocations = true;
+    double start = now();
+    int outputs = runKernel( kernel, points, n, triangles, vertices );
+    double first = now() - start;
+    countAllocations = false;
+
+    BenchmarkResult r = { 0 };
+    snprintf( r.kernel, sizeof( r.kernel ), "%s", kernelNames[kernel] );
+    snprintf( r.shape, sizeof( r.shape ), "%s", shapeNames[shape] );
+    r.vertices = n;
+    r.allocationsPerCall = allocations;
+    r.bytesPerCall = allocatedBytes;
+    r.outputs = outputs;
+
+    int calls = 1;
+    double elapsed = first;
+
+    // fast kernels are timed in batches, the best of three is kept to
+    // filter out scheduling noise
+    if ( first < MIN_SAMPLE_TIME ) {
+        calls = (int) ( MIN_SAMPLE_TIME / ( first > 1e-7 ? first : 1e-7 ) ) + 1;
+        for ( int sample = 0; sample < 3; sample++ ) {
+            start = now();
+            for ( int i = 0; i < calls; i++ ) {
+                sink += runKernel( kernel, points, n, triangles, vertices );
+            }
+            double batch = now() - start;
+            if ( sample == 0 || batch < elapsed ) {
+                elapsed = batch;
+            }
+        }
+    }
+
+    r.calls = calls;
+    r.nsPerVertex = elapsed * 1e9 / calls / n;
+
+    return r;
+
+}
+
+static int loadBaseline( const char *fileName, BenchmarkResult *results ) {
+
+    FILE *f = fopen( fileName, "r" );
+    if ( f == NULL ) {
+        fprintf( stderr, "could not open baseline %s\n", fileName );
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+
+    // header
+    if ( fgets( line, sizeof( line ), f ) == NULL ) {
+        fclose( f );
+        return 0;
+    }
+
+    while ( count < MAX_RESULTS && fgets( line, sizeof( line ), f ) != NULL ) {
+        BenchmarkResult *r = &results[count];
+        if ( sscanf( line, "%31[^,],%31[^,],%d,%lf,%lf,%lf,%d,%d",
+                     r->kernel, r->shape, &r->vertices, &r->nsPerVertex,
+                     &r->allocationsPerCall, &r->bytesPerCall, &r->outputs, &r->calls ) == 8 ) {
+            count++;
+        }
+    }
+
+    fclose( f );
+
+    return count;
+
+}
+
+static const BenchmarkResult *findResult( const BenchmarkResult *results, int count, const BenchmarkResult *r ) {
+    for ( int i = 0; i < count; i++ ) {
+        if ( results[i].vertices == r->vertices &&
+             strcmp( results[i].kernel, r->kernel ) == 0 &&
+             strcmp( results[i].shape, r->shape ) == 0 ) {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+int main( int argc, char **argv ) {
+
+    const char *csvFileName = NULL;
+    const char *baselineFileName = NULL;
+    double tolerance = 0.15;
+    int maxVertices = 100000;
+    double budget = 2.0;
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "-csv" ) == 0 && i + 1 < argc ) {
+            csvFileName = argv[++i];
+        } else if ( strcmp( argv[i], "-baseline" ) == 0 && i + 1 < argc ) {
+            baselineFileName = argv[++i];
+        } else if ( strcmp( argv[i], "-tolerance" ) == 0 && i + 1 < argc ) {
+            tolerance = atof( argv[++i] );
+        } else if ( strcmp( argv[i], "-maxVertices" ) == 0 && i + 1 < argc ) {
+            maxVertices = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-budget" ) == 0 && i + 1 < argc ) {
+            budget = atof( argv[++i] );
+        } else {
+            fprintf( stderr, "unknown option %s\n", argv[i] );
+            return 2;
+        }
+    }
+
+    // half decades: 10, 32, 100, 316, ...
+    int sizes[16];
+    int sizeQuantity = 0;
+    for ( double s = 10.0; s <= maxVertices * 1.0001 && sizeQuantity < 16; s *= sqrt( 10.0 ) ) {
+        sizes[sizeQuantity++] = (int) round( s );
+    }
+
+    int capacity = maxVertices + 8;
+
+    // the triangulation takes its indices from the frame scratch, sized
+    // here for the largest polygon
+    initMemory( sizeof( int ) * capacity );
+
+    b2Vec2 *points = (b2Vec2*) malloc( sizeof( b2Vec2 ) * capacity );
+    TriangleB2Vec2 *triangles = (TriangleB2Vec2*) malloc( sizeof( TriangleB2Vec2 ) * capacity );
+    GeometryVertex *vertices = (GeometryVertex*) malloc( sizeof( GeometryVertex ) * capacity * 3 );
+
+    BenchmarkResult *results = (BenchmarkResult*) malloc( sizeof( BenchmarkResult ) * MAX_RESULTS );
+    int resultQuantity = 0;
+
+    printf( "%-14s %-7s %8s %12s %10s %12s %9s %9s\n", "kernel", "shape", "vertices", "ns/vertex", "allocs", "bytes", "outputs", "calls" );
+
+    for ( int k = KERNEL_TRIANGULATE; k <= KERNEL_IS_TRIANGLE_CCW; k++ ) {
+        for ( int s = SHAPE_CONVEX; s <= SHAPE_COMB; s++ ) {
+
+            double lastCallTime = 0.0;
+            int lastVertices = 0;
+
+            for ( int i = 0; i < sizeQuantity && resultQuantity < MAX_RESULTS; i++ ) {
+
+                int n = generateShape( s, sizes[i], points );
+
+                // ear clipping is at least quadratic, so the next call
+                // time is estimated before running it
+                if ( lastVertices > 0 ) {
+                    double ratio = (double) n / lastVertices;
+                    if ( lastCallTime * ratio * ratio > budget ) {
+                        printf( "%-14s %-7s %8d %12s\n", kernelNames[k], shapeNames[s], n, "skipped" );
+                        continue;
+                    }
+                }
+
+                BenchmarkResult r = measure( k, s, points, n, triangles, vertices );
+                results[resultQuantity++] = r;
+                lastCallTime = r.nsPerVertex * n / 1e9;
+                lastVertices = n;
+
+                printf( "%-14s %-7s %8d %12.2f %10.1f %12.0f %9d %9d\n",
+                        r.kernel, r.shape, r.vertices, r.nsPerVertex, r.allocationsPerCall, r.bytesPerCall, r.outputs, r.calls );
+
+            }
+
+        }
+    }
+
+    if ( csvFileName != NULL ) {
+        FILE *f = fopen( csvFileName, "w" );
+        if ( f == NULL ) {
+            fprintf( stderr, "could not write %s\n", csvFileName );
+        } else {
+            fprintf( f, "kernel,shape,vertices,nsPerVertex,allocationsPerCall,bytesPerCall,outputs,calls\n" );
+            for ( int i = 0; i < resultQuantity; i++ ) {
+                BenchmarkResult *r = &results[i];
+                fprintf( f, "%s,%s,%d,%.4f,%.1f,%.0f,%d,%d\n",
+                         r->kernel, r->shape, r->vertices, r->nsPerVertex, r->allocationsPerCall, r->bytesPerCall, r->outputs, r->calls );
+            }
+            fclose( f );
+            printf( "\nresults written to %s\n", csvFileName );
+        }
+    }
+
+    int regressions = 0;
+    bool baselineMissing = false;
+
+    if ( baselineFileName != NULL ) {
+
+        BenchmarkResult *baseline = (BenchmarkResult*) malloc( sizeof( BenchmarkResult ) * MAX_RESULTS );
+        int baselineQuantity = loadBaseline( baselineFileName, baseline );
+
+        // a gate without a baseline would always pass
+        if ( baselineQuantity <= 0 ) {
+            fprintf( stderr, "no results in baseline %s\n", baselineFileName );
+            baselineMissing = true;
+        } else {
+
+            printf( "\ncomparison with %s (tolerance %.0f%%)\n", baselineFileName, tolerance * 100 );
+
+            for ( int i = 0; i < resultQuantity; i++ ) {
+
+                BenchmarkResult *r = &results[i];
+                const BenchmarkResult *b = findResult( baseline, baselineQuantity, r );
+                if ( b == NULL ) {
+                    continue;
+                }
+
+                double change = b->nsPerVertex > 0.0 ? r->nsPerVertex / b->nsPerVertex - 1.0 : 0.0;
+                bool slower = change > tolerance;
+                bool moreAllocations = r->allocationsPerCall > b->allocationsPerCall;
+                bool differentOutput = r->outputs != b->outputs;
+
+                if ( slower || moreAllocations || differentOutput ) {
+                    regressions++;
+                    printf( "REGRESSION %-14s %-7s %8d %+7.1f%% time, allocs %.1f -> %.1f, outputs %d -> %d\n",
+                            r->kernel, r->shape, r->vertices, change * 100, 
+                            b->allocationsPerCall, r->allocationsPerCall, b->outputs, r->outputs );
+                }
+
+            }
+
+            printf( "%d regressions\n", regressions );
+
+        }
+
+        free( baseline );
+
+    }
+
+    free( results );
+    free( vertices );
+    free( triangles );
+    free( points );
+
+    if ( baselineMissing ) {
+        return 2;
+    }
+
+    return regressions > 0 ? 1 : 0;
+
+}
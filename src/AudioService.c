@@ -0,0 +1,408 @@
+/**
+ * @file AudioService.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Music streaming service implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "AudioService.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+
+static void copyFileName( char *dst, const char *src ) {
+    snprintf( dst, AUDIO_SERVICE_MAX_PATH, "%s", src != NULL ? src : "" );
+}
+
+static bool pushAudioCommand( AudioCommandQueue *q, const AudioCommand *command ) {
+
+    int tail = atomic_load_explicit( &q->tail, memory_order_relaxed );
+    int head = atomic_load_explicit( &q->head, memory_order_acquire );
+
+    if ( tail - head == AUDIO_SERVICE_QUEUE_SIZE ) {
+        return false;
+    }
+
+    q->commands[tail & ( AUDIO_SERVICE_QUEUE_SIZE - 1 )] = *command;
+    atomic_store_explicit( &q->tail, tail + 1, memory_order_release );
+
+    return true;
+
+}
+
+static bool popAudioCommand( AudioCommandQueue *q, AudioCommand *command ) {
+
+    int head = atomic_load_explicit( &q->head, memory_order_relaxed );
+    int tail = atomic_load_explicit( &q->tail, memory_order_acquire );
+
+    if ( head == tail ) {
+        return false;
+    }
+
+    *command = q->commands[head & ( AUDIO_SERVICE_QUEUE_SIZE - 1 )];
+    atomic_store_explicit( &q->head, head + 1, memory_order_release );
+
+    return true;
+
+}
+
+static bool pushAudioEvent( AudioEventQueue *q, AudioEventType type, const char *fileName ) {
+
+    int tail = atomic_load_explicit( &q->tail, memory_order_relaxed );
+    int head = atomic_load_explicit( &q->head, memory_order_acquire );
+
+    if ( tail - head == AUDIO_SERVICE_QUEUE_SIZE ) {
+        return false;
+    }
+
+    AudioEvent *e = &q->events[tail & ( AUDIO_SERVICE_QUEUE_SIZE - 1 )];
+    e->type = type;
+    copyFileName( e->fileName, fileName );
+    atomic_store_explicit( &q->tail, tail + 1, memory_order_release );
+
+    return true;
+
+}
+
+static bool popAudioEvent( AudioEventQueue *q, AudioEvent *event ) {
+
+    int head = atomic_load_explicit( &q->head, memory_order_relaxed );
+    int tail = atomic_load_explicit( &q->tail, memory_order_acquire );
+
+    if ( head == tail ) {
+        return false;
+    }
+
+    *event = q->events[head & ( AUDIO_SERVICE_QUEUE_SIZE - 1 )];
+    atomic_store_explicit( &q->head, head + 1, memory_order_release );
+
+    return true;
+
+}
+
+static void unloadMusicVoice( AudioService *as, MusicVoice *v ) {
+
+    if ( !v->active ) {
+        return;
+    }
+
+    StopMusicStream( v->music );
+    UnloadMusicStream( v->music );
+    v->active = false;
+
+    pushAudioEvent( &as->events, AUDIO_EVENT_STOPPED, v->fileName );
+
+}
+
+static bool loadMusicVoice( AudioService *as, MusicVoice *v, const char *fileName, float volume ) {
+
+    // decoding the header and the first buffers happens here, away from
+    // the game loop
+    v->music = LoadMusicStream( fileName );
+
+    if ( !IsMusicValid( v->music ) ) {
+        pushAudioEvent( &as->events, AUDIO_EVENT_LOAD_FAILED, fileName );
+        return false;
+    }
+
+    copyFileName( v->fileName, fileName );
+    v->music.looping = true;
+    v->active = true;
+    v->volume = volume;
+    v->targetVolume = volume;
+    v->fadeSpeed = 0.0f;
+
+    SetMusicVolume( v->music, v->volume * as->masterVolume );
+    PlayMusicStream( v->music );
+    pushAudioEvent( &as->events, AUDIO_EVENT_STARTED, fileName );
+
+    return true;
+
+}
+
+static void executeAudioCommand( AudioService *as, const AudioCommand *c ) {
+
+    switch ( c->type ) {
+
+        case AUDIO_COMMAND_PLAY:
+            unloadMusicVoice( as, &as->voices[0] );
+            unloadMusicVoice( as, &as->voices[1] );
+            loadMusicVoice( as, &as->voices[0], c->fileName, 1.0f );
+            break;
+
+        case AUDIO_COMMAND_CROSSFADE: {
+
+            float speed = c->value > 0.0f ? 1.0f / c->value : 1000.0f;
+
+            // a track still fading out from the last crossfade is cut
+            MusicVoice *voice = NULL;
+            for ( int i = 0; i < 2 && voice == NULL; i++ ) {
+                if ( !as->voices[i].active ) {
+                    voice = &as->voices[i];
+                }
+            }
+            if ( voice == NULL ) {
+                voice = as->voices[0].targetVolume < as->voices[1].targetVolume ? &as->voices[0] : &as->voices[1];
+                unloadMusicVoice( as, voice );
+            }
+
+            MusicVoice *other = voice == &as->voices[0] ? &as->voices[1] : &as->voices[0];
+            other->targetVolume = 0.0f;
+            other->fadeSpeed = speed;
+
+            if ( loadMusicVoice( as, voice, c->fileName, 0.0f ) ) {
+                voice->targetVolume = 1.0f;
+                voice->fadeSpeed = speed;
+            }
+
+            break;
+
+        }
+
+        case AUDIO_COMMAND_STOP:
+            for ( int i = 0; i < 2; i++ ) {
+                as->voices[i].targetVolume = 0.0f;
+                as->voices[i].fadeSpeed = c->value > 0.0f ? 1.0f / c->value : 1000.0f;
+            }
+            break;
+
+        case AUDIO_COMMAND_VOLUME:
+            as->masterVolume = c->value < 0.0f ? 0.0f : c->value > 1.0f ? 1.0f : c->value;
+            break;
+
+    }
+
+    atomic_fetch_add( &as->processedCommands, 1 );
+
+}
+
+static void refillMusic( AudioService *as, float delta, double now ) {
+
+    bool streaming = false;
+    double buffered = 0.0;
+
+    for ( int i = 0; i < 2; i++ ) {
+
+        MusicVoice *v = &as->voices[i];
+        if ( !v->active ) {
+            continue;
+        }
+
+        if ( v->volume < v->targetVolume ) {
+            v->volume = v->volume + v->fadeSpeed * delta > v->targetVolume ? v->targetVolume : v->volume + v->fadeSpeed * delta;
+        } else if ( v->volume > v->targetVolume ) {
+            v->volume = v->volume - v->fadeSpeed * delta < v->targetVolume ? v->targetVolume : v->volume - v->fadeSpeed * delta;
+        }
+
+        if ( v->volume <= 0.0f && v->targetVolume <= 0.0f ) {
+            unloadMusicVoice( as, v );
+            continue;
+        }
+
+        SetMusicVolume( v->music, v->volume * as->masterVolume );
+        UpdateMusicStream( v->music );
+        streaming = true;
+        buffered = 2.0 * AUDIO_SERVICE_BUFFER_FRAMES / v->music.stream.sampleRate;
+
+    }
+
+    if ( streaming ) {
+        if ( as->lastRefill > 0.0 ) {
+            // both buffers were played before this refill, the device got
+            // silence in between
+            if ( now - as->lastRefill > buffered ) {
+                atomic_fetch_add( &as->underruns, 1 );
+            }
+            int gap = (int) ( ( now - as->lastRefill ) * 1000000.0 );
+            if ( gap > atomic_load( &as->maxGapMicroseconds ) ) {
+                atomic_store( &as->maxGapMicroseconds, gap );
+            }
+        }
+        as->lastRefill = now;
+        atomic_fetch_add( &as->refills, 1 );
+    } else {
+        as->lastRefill = 0.0;
+    }
+
+}
+
+static void *runAudio( void *data ) {
+
+    AudioService *as = (AudioService*) data;
+    double last = GetTime();
+
+    while ( atomic_load( &as->running ) ) {
+
+        AudioCommand command;
+        while ( popAudioCommand( &as->commands, &command ) ) {
+            executeAudioCommand( as, &command );
+        }
+
+        double now = GetTime();
+        refillMusic( as, (float) ( now - last ), now );
+        last = now;
+
+        WaitTime( AUDIO_SERVICE_PERIOD );
+
+    }
+
+    for ( int i = 0; i < 2; i++ ) {
+        unloadMusicVoice( as, &as->voices[i] );
+    }
+
+    return NULL;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated AudioService struct instance
+ * and starts its thread. Needs an initialized audio device. Returns
+ * NULL if the thread can't be started.
+ */
+AudioService* createAudioService( void ) {
+
+    AudioService *as = (AudioService*) allocMemory( MEMORY_SUBSYSTEM_WINDOW, sizeof( AudioService ) );
+
+    atomic_init( &as->commands.head, 0 );
+    atomic_init( &as->commands.tail, 0 );
+    atomic_init( &as->events.head, 0 );
+    atomic_init( &as->events.tail, 0 );
+
+    for ( int i = 0; i < 2; i++ ) {
+        as->voices[i].active = false;
+        as->voices[i].fileName[0] = '\0';
+    }
+    as->masterVolume = 1.0f;
+    as->lastRefill = 0.0;
+
+    atomic_init( &as->refills, 0 );
+    atomic_init( &as->underruns, 0 );
+    atomic_init( &as->processedCommands, 0 );
+    atomic_init( &as->maxGapMicroseconds, 0 );
+
+    as->droppedCommands = 0;
+    as->nowPlaying[0] = '\0';
+
+    atomic_init( &as->running, true );
+
+    if ( pthread_create( &as->thread, NULL, runAudio, as ) != 0 ) {
+        TraceLog( LOG_WARNING, "AUDIO: could not start the audio thread" );
+        freeMemory( as );
+        return NULL;
+    }
+
+    // the streams loaded from now on get the larger buffers, the thread
+    // only loads them when a command arrives
+    SetAudioStreamBufferSizeDefault( AUDIO_SERVICE_BUFFER_FRAMES );
+
+    return as;
+
+}
+
+/**
+ * @brief Stops the thread and destroys an AudioService object and its
+ * music streams.
+ */
+void destroyAudioService( AudioService *as ) {
+
+    atomic_store( &as->running, false );
+    pthread_join( as->thread, NULL );
+
+    freeMemory( as );
+
+}
+
+static bool sendAudioCommand( AudioService *as, AudioCommandType type, const char *fileName, float value ) {
+
+    AudioCommand command;
+    command.type = type;
+    copyFileName( command.fileName, fileName );
+    command.value = value;
+
+    if ( !pushAudioCommand( &as->commands, &command ) ) {
+        as->droppedCommands++;
+        return false;
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Starts a track, replacing what is playing. Returns false if the
+ * command queue is full.
+ */
+bool playAudioServiceMusic( AudioService *as, const char *fileName ) {
+    return sendAudioCommand( as, AUDIO_COMMAND_PLAY, fileName, 0.0f );
+}
+
+/**
+ * @brief Fades out and stops the music.
+ */
+bool stopAudioServiceMusic( AudioService *as, float seconds ) {
+    return sendAudioCommand( as, AUDIO_COMMAND_STOP, NULL, seconds );
+}
+
+/**
+ * @brief Fades from what is playing to a new track.
+ */
+bool crossfadeAudioServiceMusic( AudioService *as, const char *fileName, float seconds ) {
+    return sendAudioCommand( as, AUDIO_COMMAND_CROSSFADE, fileName, seconds );
+}
+
+/**
+ * @brief Sets the volume of the music, from 0 to 1.
+ */
+bool setAudioServiceVolume( AudioService *as, float volume ) {
+    return sendAudioCommand( as, AUDIO_COMMAND_VOLUME, NULL, volume );
+}
+
+/**
+ * @brief Consumes the events of the audio thread. Called once per frame
+ * by the game thread.
+ */
+void updateAudioService( AudioService *as ) {
+
+    AudioEvent event;
+
+    while ( popAudioEvent( &as->events, &event ) ) {
+        switch ( event.type ) {
+            case AUDIO_EVENT_STARTED:
+                TraceLog( LOG_INFO, "AUDIO: streaming %s", event.fileName );
+                copyFileName( as->nowPlaying, event.fileName );
+                break;
+            case AUDIO_EVENT_LOAD_FAILED:
+                TraceLog( LOG_WARNING, "AUDIO: could not load %s", event.fileName );
+                break;
+            case AUDIO_EVENT_STOPPED:
+                if ( strcmp( as->nowPlaying, event.fileName ) == 0 ) {
+                    as->nowPlaying[0] = '\0';
+                }
+                break;
+        }
+    }
+
+}
+
+/**
+ * @brief Draws the streaming counters.
+ */
+void drawAudioServiceStats( AudioService *as, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "music %s: %d refills, %d underruns, max gap %.1fms, %d commands, %d dropped",
+            as->nowPlaying[0] != '\0' ? GetFileName( as->nowPlaying ) : "off",
+            atomic_load( &as->refills ), atomic_load( &as->underruns ),
+            atomic_load( &as->maxGapMicroseconds ) / 1000.0f,
+            atomic_load( &as->processedCommands ), as->droppedCommands
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
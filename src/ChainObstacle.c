@@ -4,39 +4,207 @@
 #include "ChainObstacle.h"
 #include "Types.h"
 #include "DrawingUtils.h"
+#include "PolygonUtils.h"
 
 #include "raylib/raylib.h"
 #include "box2d/box2d.h"
 
-void createChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, GameWorld *gw ) {
+void createChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, unsigned int flags, GameWorld *gw ) {
+    if ( addChainObstacle( points, pointQuantity, color, isConcave, flags, gw ) > 0 ) {
+        gw->staticRevision++;
+    }
+}
 
-    assert( gw->chainObstacleQuantity < MAX_CHAIN_OBSTACLES && pointQuantity < MAX_CHAIN_OBSTACLE_POINTS );
+/**
+ * @brief Creates the chain obstacles of an outline without incrementing
+ * the static revision, for callers that invalidate what they changed.
+ * Returns how many chain obstacles were created.
+ */
+int addChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, unsigned int flags, GameWorld *gw ) {
+
+    // the vertices are stored inline in the obstacle, longer outlines must
+    // be split or simplified by the caller
+    if ( pointQuantity >= MAX_CHAIN_OBSTACLE_POINTS ) {
+        TraceLog( LOG_WARNING, "CHAIN: outline of %d vertices ignored, the limit is %d", pointQuantity, MAX_CHAIN_OBSTACLE_POINTS - 1 );
+        return 0;
+    }
 
-    ChainObstacle *co = &gw->chainObstacles[gw->chainObstacleQuantity++];
+    if ( gw->chainObstacleQuantity >= MAX_CHAIN_OBSTACLES ) {
+        TraceLog( LOG_WARNING, "CHAIN: no free chain obstacle" );
+        return 0;
+    }
 
-    b2BodyDef bodyDef = b2DefaultBodyDef();
-    bodyDef.type = b2_staticBody;
-    bodyDef.userData = "chain";
-    co->bodyId = b2CreateBody( gw->worldId, &bodyDef );
+    ChainObstacle *co = &gw->chainObstacles[gw->chainObstacleQuantity];
 
     for ( int i = 0; i < pointQuantity; i++ ) {
         co->points[i] = points[i];
     }
-    co->pointQuantity = pointQuantity;
+
+    // clicked and hand made outlines have duplicated and nearly collinear
+    // vertices, whose tiny segments only cost and produce spurious contacts
+    PolygonCleanupSettings cleanup = {
+        CHAIN_OBSTACLE_WELD_TOLERANCE,
+        CHAIN_OBSTACLE_COLLINEAR_TOLERANCE,
+        CHAIN_OBSTACLE_SIMPLIFY_TOLERANCE
+    };
+    co->pointQuantity = cleanupPolygon( co->points, pointQuantity, &cleanup );
+
+    if ( co->pointQuantity < 3 ) {
+        TraceLog( LOG_WARNING, "CHAIN: degenerate outline of %d vertices ignored", pointQuantity );
+        return 0;
+    }
+
+    // self intersecting outlines can't be triangulated and collide on the
+    // wrong side of some segments, they are split in simple loops
+    int edgeA;
+    int edgeB;
+    b2Vec2 intersection;
+    if ( findPolygonSelfIntersection( co->points, co->pointQuantity, &edgeA, &edgeB, &intersection ) ) {
+
+        bool adjacent = edgeB == edgeA + 1 || ( edgeA == 0 && edgeB == co->pointQuantity - 1 );
+
+        if ( !CHAIN_OBSTACLE_SPLIT_SELF_INTERSECTIONS || adjacent ) {
+            TraceLog( 
+                LOG_WARNING, "CHAIN: self intersecting outline ignored, edges %d and %d meet at %.2f, %.2f", 
+                edgeA, edgeB, intersection.x, intersection.y 
+            );
+            return 0;
+        }
+
+        b2Vec2 first[MAX_CHAIN_OBSTACLE_POINTS];
+        b2Vec2 second[MAX_CHAIN_OBSTACLE_POINTS];
+        int firstQuantity;
+        int secondQuantity;
+        splitPolygonAtIntersection( 
+            co->points, co->pointQuantity, edgeA, edgeB, intersection, 
+            first, &firstQuantity, second, &secondQuantity 
+        );
+
+        TraceLog( LOG_INFO, "CHAIN: self intersecting outline split at %.2f, %.2f", intersection.x, intersection.y );
+
+        // each loop is smaller, so the recursion ends
+        return addChainObstacle( first, firstQuantity, color, isConcave, flags, gw ) +
+               addChainObstacle( second, secondQuantity, color, isConcave, flags, gw );
+
+    }
+
+    // the chains collide on their outer side and are drawn clockwise,
+    // whatever the order the vertices were given in
+    if ( computePolygonSignedArea( co->points, co->pointQuantity ) < 0.0f ) {
+        reversePolygon( co->points, co->pointQuantity );
+    }
+
+    // solid obstacles are convex polygon shapes, nothing can tunnel into
+    // them and they generate less contacts than the chain segments
+    ConvexPiece pieces[MAX_CHAIN_OBSTACLE_POINTS];
+    int pieceQuantity = 0;
+    if ( gw->solidChainObstacles ) {
+        pieceQuantity = decomposeConvexPolygon( co->points, co->pointQuantity, pieces, MAX_CHAIN_OBSTACLE_POINTS );
+        if ( pieceQuantity == 0 ) {
+            TraceLog( LOG_WARNING, "CHAIN: outline of %d vertices can't be decomposed, using a chain", co->pointQuantity );
+        }
+    }
+
+    gw->chainObstacleQuantity++;
+
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_staticBody;
+    bodyDef.userData = co;
+    co->bodyId = b2CreateBody( gw->worldId, &bodyDef );
 
     // add two more points, one for loop, one to prevend misscollision
-    co->points[co->pointQuantity++] = points[0];
-    co->points[co->pointQuantity++] = points[0];
+    co->points[co->pointQuantity++] = co->points[0];
+    co->points[co->pointQuantity++] = co->points[0];
 
-    b2ChainDef chainDef = b2DefaultChainDef();
-    chainDef.points = co->points;
-    chainDef.count = co->pointQuantity;
-    chainDef.userData = co;
-    
-    co->chainId = b2CreateChain( co->bodyId, &chainDef );
+    co->solid = pieceQuantity > 0;
+    co->shapeQuantity = 0;
+
+    bool oneWay = ( flags & SHAPE_FLAG_ONE_WAY ) != 0;
+
+    if ( co->solid ) {
 
+        b2ShapeDef shapeDef = b2DefaultShapeDef();
+        shapeDef.userData = co;
+        shapeDef.enablePreSolveEvents = oneWay;
+
+        for ( int i = 0; i < pieceQuantity; i++ ) {
+            b2Hull hull = b2ComputeHull( pieces[i].points, pieces[i].pointCount );
+            if ( hull.count > 0 ) {
+                b2Polygon polygon = b2MakePolygon( &hull, 0.0f );
+                b2CreatePolygonShape( co->bodyId, &shapeDef, &polygon );
+                co->shapeQuantity++;
+            }
+        }
+
+        co->chainId = b2_nullChainId;
+
+    } else {
+
+        b2ChainDef chainDef = b2DefaultChainDef();
+        chainDef.points = co->points;
+        chainDef.count = co->pointQuantity;
+        chainDef.userData = co;
+        
+        co->chainId = b2CreateChain( co->bodyId, &chainDef );
+        co->shapeQuantity = co->pointQuantity - 1;
+
+        // chain definitions have no presolve flag
+        if ( oneWay ) {
+            b2ShapeId segments[MAX_CHAIN_OBSTACLE_POINTS+2];
+            int segmentQuantity = b2Chain_GetSegments( co->chainId, segments, MAX_CHAIN_OBSTACLE_POINTS+2 );
+            for ( int i = 0; i < segmentQuantity; i++ ) {
+                b2Shape_EnablePreSolveEvents( segments[i], true );
+            }
+        }
+
+    }
+
+    if ( oneWay ) {
+        gw->oneWayPlatforms.stats.platformShapes += co->shapeQuantity;
+    }
+
+    co->type = ENTITY_TYPE_CHAIN_OBSTACLE;
     co->color = color;
     co->isConcave = isConcave;
+    co->flags = flags;
+    co->changedTick = gw->tick;
+
+    return 1;
+
+}
+
+/**
+ * @brief Destroys a chain obstacle and moves the last one into its slot,
+ * so the slots and their vertex storage are reused. The moved obstacle's
+ * body and shapes are pointed to its new slot. Doesn't increment the
+ * static revision.
+ */
+void removeChainObstacle( int index, GameWorld *gw ) {
+
+    assert( index >= 0 && index < gw->chainObstacleQuantity );
+
+    ChainObstacle *co = &gw->chainObstacles[index];
+    b2DestroyBody( co->bodyId );
+
+    if ( ( co->flags & SHAPE_FLAG_ONE_WAY ) != 0 ) {
+        gw->oneWayPlatforms.stats.platformShapes -= co->shapeQuantity;
+    }
+
+    int last = --gw->chainObstacleQuantity;
+    if ( index == last ) {
+        return;
+    }
+
+    *co = gw->chainObstacles[last];
+    co->changedTick = gw->tick;
+
+    b2Body_SetUserData( co->bodyId, co );
+
+    b2ShapeId shapes[MAX_CHAIN_OBSTACLE_POINTS+2];
+    int shapeQuantity = b2Body_GetShapes( co->bodyId, shapes, MAX_CHAIN_OBSTACLE_POINTS+2 );
+    for ( int i = 0; i < shapeQuantity; i++ ) {
+        b2Shape_SetUserData( shapes[i], co );
+    }
 
 }
 
@@ -60,6 +228,10 @@ void drawChainObstacle( ChainObstacle *co ) {
     
     drawShapeLinesB2Vec2( co->points, co->pointQuantity, BLACK );
 
+}
+
+void drawChainObstacleLabels( ChainObstacle *co ) {
+
     for ( int i = 0; i < co->pointQuantity; i++ ) {
         DrawText( 
             TextFormat( "%.2f %.2f", co->points[i].x, co->points[i].y ), 
@@ -10,6 +10,8 @@
 #include <stdbool.h>
 
 #include "DrawingUtils.h"
+#include "GeometryBuffer.h"
+#include "Memory.h"
 #include "raylib/raylib.h"
 #include "raylib/rlgl.h"
 
@@ -19,11 +21,57 @@ typedef struct Triangle {
     Vector2 c;
 } Triangle;
 
-typedef struct TriangleB2Vec2 {
-    b2Vec2 a;
-    b2Vec2 b;
-    b2Vec2 c;
-} TriangleB2Vec2;
+// when set, the B2Vec2 shapes are written into it instead of rlgl
+static GeometryBuffer *geometryBuffer = NULL;
+
+static ConcaveFillMode concaveFillMode = CONCAVE_FILL_TRIANGULATE;
+
+// rlgl doesn't expose the stencil buffer, but the few functions needed
+// are OpenGL 1.1 ones, exported by every OpenGL library
+#if defined( _WIN32 ) && !defined( _WIN64 )
+    #define DRAWING_GL_API __stdcall
+#else
+    #define DRAWING_GL_API
+#endif
+
+#define DRAWING_GL_ZERO 0x0000
+#define DRAWING_GL_NOTEQUAL 0x0205
+#define DRAWING_GL_ALWAYS 0x0207
+#define DRAWING_GL_STENCIL_BUFFER_BIT 0x0400
+#define DRAWING_GL_STENCIL_TEST 0x0B90
+#define DRAWING_GL_INVERT 0x150A
+#define DRAWING_GL_KEEP 0x1E00
+
+extern void DRAWING_GL_API glEnable( unsigned int cap );
+extern void DRAWING_GL_API glDisable( unsigned int cap );
+extern void DRAWING_GL_API glClear( unsigned int mask );
+extern void DRAWING_GL_API glClearStencil( int s );
+extern void DRAWING_GL_API glStencilFunc( unsigned int func, int ref, unsigned int mask );
+extern void DRAWING_GL_API glStencilOp( unsigned int fail, unsigned int zfail, unsigned int zpass );
+extern void DRAWING_GL_API glStencilMask( unsigned int mask );
+
+void setDrawingGeometryBuffer( GeometryBuffer *gb ) {
+    geometryBuffer = gb;
+}
+
+void setConcaveFillMode( ConcaveFillMode mode ) {
+    concaveFillMode = mode;
+}
+
+void clearStencilBuffer( void ) {
+    rlDrawRenderBatchActive();
+    glClearStencil( 0 );
+    glClear( DRAWING_GL_STENCIL_BUFFER_BIT );
+}
+
+static void writeGeometryVertex( GeometryVertex *v, b2Vec2 p, Color color ) {
+    v->x = p.x;
+    v->y = p.y;
+    v->color[0] = color.r;
+    v->color[1] = color.g;
+    v->color[2] = color.b;
+    v->color[3] = color.a;
+}
 
 bool isConvex( Vector2 prev, Vector2 curr, Vector2 next ) {
     return (curr.x - prev.x) * (next.y - curr.y) - (curr.y - prev.y) * (next.x - curr.x) < 0;
@@ -44,7 +92,15 @@ int triangulatePolygon( const Vector2 *points, int pointCount, Triangle *triangl
         return 0;
     }
 
-    int *indices = (int*) malloc( sizeof(int) * pointCount );
+    // the indices are a frame scratch temporary, the heap is only used
+    // when the scratch is full
+    size_t scratchMark = getFrameScratchMark();
+    int *indices = (int*) allocFrameScratch( sizeof(int) * pointCount );
+    bool scratch = indices != NULL;
+    if ( !scratch ) {
+        indices = (int*) allocMemory( MEMORY_SUBSYSTEM_SCRATCH, sizeof(int) * pointCount );
+    }
+
     for ( int i = 0; i < pointCount; i++ ) {
         indices[i] = i;
     }
@@ -118,7 +174,11 @@ int triangulatePolygon( const Vector2 *points, int pointCount, Triangle *triangl
         };
     }
 
-    free( indices );
+    if ( scratch ) {
+        releaseFrameScratch( scratchMark );
+    } else {
+        freeMemory( indices );
+    }
 
     return triCount;
 
@@ -241,7 +301,15 @@ int triangulatePolygonB2Vec2( const b2Vec2 *points, int pointCount, TriangleB2Ve
         return 0;
     }
 
-    int *indices = (int*) malloc( sizeof(int) * pointCount );
+    // the indices are a frame scratch temporary, the heap is only used
+    // when the scratch is full
+    size_t scratchMark = getFrameScratchMark();
+    int *indices = (int*) allocFrameScratch( sizeof(int) * pointCount );
+    bool scratch = indices != NULL;
+    if ( !scratch ) {
+        indices = (int*) allocMemory( MEMORY_SUBSYSTEM_SCRATCH, sizeof(int) * pointCount );
+    }
+
     for ( int i = 0; i < pointCount; i++ ) {
         indices[i] = i;
     }
@@ -315,7 +383,11 @@ int triangulatePolygonB2Vec2( const b2Vec2 *points, int pointCount, TriangleB2Ve
         };
     }
 
-    free( indices );
+    if ( scratch ) {
+        releaseFrameScratch( scratchMark );
+    } else {
+        freeMemory( indices );
+    }
 
     return triCount;
 
@@ -323,9 +395,32 @@ int triangulatePolygonB2Vec2( const b2Vec2 *points, int pointCount, TriangleB2Ve
 
 void drawConcaveShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw ) {
 
+    if ( concaveFillMode == CONCAVE_FILL_STENCIL ) {
+        drawStencilShapeB2Vec2( points, pointCount, color );
+        return;
+    }
+
     TriangleB2Vec2 triangles[128];
     int triCount = triangulatePolygonB2Vec2( points, pointCount, triangles, 128, cw );
 
+    GeometryVertex *v = geometryBuffer != NULL ? reserveGeometryVertices( geometryBuffer, triCount * 3 ) : NULL;
+    if ( v != NULL ) {
+        for ( int i = 0; i < triCount; i++ ) {
+            b2Vec2 a = triangles[i].a;
+            b2Vec2 b = triangles[i].b;
+            b2Vec2 c = triangles[i].c;
+            if ( !isTriangleCCWB2Vec2( a, b, c ) ) {
+                b2Vec2 tmp = b;
+                b = c;
+                c = tmp;
+            }
+            writeGeometryVertex( v++, a, color );
+            writeGeometryVertex( v++, b, color );
+            writeGeometryVertex( v++, c, color );
+        }
+        return;
+    }
+
     rlBegin( RL_TRIANGLES );
     rlColor4ub( color.r, color.g, color.b, color.a );
 
@@ -351,12 +446,53 @@ void drawConcaveShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color,
 
 }
 
+/**
+ * @brief Writes the centroid fan of a shape, pointCount triangles, into
+ * vertices. Returns the quantity of vertices written.
+ */
+int writeShapeFanB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw, GeometryVertex *vertices ) {
+
+    if ( pointCount < 3 ) {
+        return 0;
+    }
+
+    b2Vec2 center = { 0 };
+    for ( int i = 0; i < pointCount; i++ ) {
+        center.x += points[i].x;
+        center.y += points[i].y;
+    }
+    center.x /= pointCount;
+    center.y /= pointCount;
+
+    GeometryVertex *v = vertices;
+    for ( int i = 0; i < pointCount; i++ ) {
+        writeGeometryVertex( v++, center, color );
+        if ( cw ) {
+            int j = pointCount - 1 - i;
+            writeGeometryVertex( v++, points[(j + 1) % pointCount], color );
+            writeGeometryVertex( v++, points[j], color );
+        } else {
+            writeGeometryVertex( v++, points[i], color );
+            writeGeometryVertex( v++, points[(i + 1) % pointCount], color );
+        }
+    }
+
+    return pointCount * 3;
+
+}
+
 void drawShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw ) {
 
     if ( pointCount < 3 ) {
         return;
     }
 
+    GeometryVertex *v = geometryBuffer != NULL ? reserveGeometryVertices( geometryBuffer, pointCount * 3 ) : NULL;
+    if ( v != NULL ) {
+        writeShapeFanB2Vec2( points, pointCount, color, cw, v );
+        return;
+    }
+
     b2Vec2 center = { 0 };
     for ( int i = 0; i < pointCount; i++ ) {
         center.x += points[i].x;
@@ -396,6 +532,27 @@ void drawShapeLinesB2Vec2( const b2Vec2 *points, int pointCount, Color color ) {
         return;
     }
 
+    // lines are streamed as one pixel wide quads, so they share the
+    // triangle draw call with the fills
+    GeometryVertex *v = geometryBuffer != NULL ? reserveGeometryVertices( geometryBuffer, pointCount * 6 ) : NULL;
+    if ( v != NULL ) {
+        for ( int i = 0; i < pointCount; i++ ) {
+            b2Vec2 p1 = points[i];
+            b2Vec2 p2 = points[(i + 1) % pointCount];
+            b2Vec2 n = b2MulSV( 0.5f, b2LeftPerp( b2Normalize( b2Sub( p2, p1 ) ) ) );
+            b2Vec2 q[4] = { b2Add( p1, n ), b2Sub( p1, n ), b2Sub( p2, n ), b2Add( p2, n ) };
+            int order[6] = { 0, 1, 2, 0, 2, 3 };
+            if ( !isTriangleCCWB2Vec2( q[0], q[1], q[2] ) ) {
+                order[1] = 2; order[2] = 1;
+                order[4] = 3; order[5] = 2;
+            }
+            for ( int j = 0; j < 6; j++ ) {
+                writeGeometryVertex( v++, q[order[j]], color );
+            }
+        }
+        return;
+    }
+
     rlBegin( RL_LINES );
     rlColor4ub( color.r, color.g, color.b, color.a );
 
@@ -408,4 +565,67 @@ void drawShapeLinesB2Vec2( const b2Vec2 *points, int pointCount, Color color ) {
 
     rlEnd();
 
+}
+// Stencil then cover: a triangle fan from the first vertex inverts the
+// stencil bit of every pixel it covers, so pixels inside the polygon end
+// up with an odd count (even-odd rule), whatever its shape. A quad over
+// the bounding box then fills only those pixels and zeroes the stencil
+// back. O(n) vertices and no triangulation at all.
+void drawStencilShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color ) {
+
+    if ( pointCount < 3 ) {
+        return;
+    }
+
+    if ( geometryBuffer != NULL ) {
+        flushGeometryBuffer( geometryBuffer );
+    }
+    rlDrawRenderBatchActive();
+
+    b2Vec2 min = points[0];
+    b2Vec2 max = points[0];
+    for ( int i = 1; i < pointCount; i++ ) {
+        min = b2Min( min, points[i] );
+        max = b2Max( max, points[i] );
+    }
+
+    // the fan triangles have mixed windings
+    rlDisableBackfaceCulling();
+    glEnable( DRAWING_GL_STENCIL_TEST );
+    glStencilMask( 0x01 );
+
+    // stencil pass
+    rlColorMask( false, false, false, false );
+    glStencilFunc( DRAWING_GL_ALWAYS, 0, 0x01 );
+    glStencilOp( DRAWING_GL_KEEP, DRAWING_GL_KEEP, DRAWING_GL_INVERT );
+
+    rlBegin( RL_TRIANGLES );
+    rlColor4ub( color.r, color.g, color.b, color.a );
+    for ( int i = 1; i < pointCount - 1; i++ ) {
+        rlVertex2f( points[0].x, points[0].y );
+        rlVertex2f( points[i].x, points[i].y );
+        rlVertex2f( points[i+1].x, points[i+1].y );
+    }
+    rlEnd();
+    rlDrawRenderBatchActive();
+
+    // cover pass
+    rlColorMask( true, true, true, true );
+    glStencilFunc( DRAWING_GL_NOTEQUAL, 0, 0x01 );
+    glStencilOp( DRAWING_GL_ZERO, DRAWING_GL_ZERO, DRAWING_GL_ZERO );
+
+    rlBegin( RL_TRIANGLES );
+    rlColor4ub( color.r, color.g, color.b, color.a );
+    rlVertex2f( min.x, min.y );
+    rlVertex2f( min.x, max.y );
+    rlVertex2f( max.x, max.y );
+    rlVertex2f( min.x, min.y );
+    rlVertex2f( max.x, max.y );
+    rlVertex2f( max.x, min.y );
+    rlEnd();
+    rlDrawRenderBatchActive();
+
+    glDisable( DRAWING_GL_STENCIL_TEST );
+    rlEnableBackfaceCulling();
+
 }
\ No newline at end of file
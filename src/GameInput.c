@@ -0,0 +1,72 @@
+/**
+ * @file GameInput.c
+ * @author Prof. Dr. David Buzatto
+ * @brief GameInput implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdbool.h>
+
+#include "GameInput.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+
+/**
+ * @brief Reads the current keyboard and mouse state. Must be called from
+ * the thread that owns the window.
+ */
+GameInput readGameInput( void ) {
+
+    return (GameInput) {
+        .moveLeft = IsKeyDown( KEY_LEFT ) || IsKeyDown( KEY_A ),
+        .moveRight = IsKeyDown( KEY_RIGHT ) || IsKeyDown( KEY_D ),
+        .jump = IsKeyPressed( KEY_SPACE ),
+        .mousePosition = GetMousePosition(),
+        .addChainPoint = IsMouseButtonPressed( MOUSE_BUTTON_LEFT ),
+        .finishChain = IsKeyPressed( KEY_ENTER ),
+        .cancelChain = IsKeyPressed( KEY_ESCAPE ),
+        .spawnDynamicObstacle = IsMouseButtonPressed( MOUSE_BUTTON_RIGHT ),
+        .carveTerrain = IsMouseButtonPressed( MOUSE_BUTTON_MIDDLE ),
+        .emitParticles = IsKeyDown( KEY_P ),
+        .toggleDebugInfo = IsKeyPressed( KEY_F1 ),
+        .toggleParallelQueries = IsKeyPressed( KEY_F2 ),
+        .togglePhysicsLOD = IsKeyPressed( KEY_F3 ),
+        .toggleSleep = IsKeyPressed( KEY_F4 ),
+        .reloadLevel = IsKeyPressed( KEY_R ),
+        .nextLevel = IsKeyPressed( KEY_N ),
+        .toggleSolidChains = IsKeyPressed( KEY_C ),
+        .toggleOneWayPlatforms = IsKeyPressed( KEY_O )
+    };
+
+}
+
+/**
+ * @brief Accumulates src into dst: held keys and mouse position are
+ * replaced and one-shot events are kept until consumed.
+ */
+void mergeGameInput( GameInput *dst, const GameInput *src ) {
+
+    dst->moveLeft = src->moveLeft;
+    dst->moveRight = src->moveRight;
+    dst->emitParticles = src->emitParticles;
+    dst->mousePosition = src->mousePosition;
+
+    dst->jump = dst->jump || src->jump;
+    dst->addChainPoint = dst->addChainPoint || src->addChainPoint;
+    dst->finishChain = dst->finishChain || src->finishChain;
+    dst->cancelChain = dst->cancelChain || src->cancelChain;
+    dst->spawnDynamicObstacle = dst->spawnDynamicObstacle || src->spawnDynamicObstacle;
+    dst->carveTerrain = dst->carveTerrain || src->carveTerrain;
+    dst->reloadLevel = dst->reloadLevel || src->reloadLevel;
+    dst->nextLevel = dst->nextLevel || src->nextLevel;
+    dst->toggleSolidChains = dst->toggleSolidChains != src->toggleSolidChains;
+
+    // toggles pressed twice before being consumed cancel each other
+    dst->toggleDebugInfo = dst->toggleDebugInfo != src->toggleDebugInfo;
+    dst->toggleParallelQueries = dst->toggleParallelQueries != src->toggleParallelQueries;
+    dst->togglePhysicsLOD = dst->togglePhysicsLOD != src->togglePhysicsLOD;
+    dst->toggleSleep = dst->toggleSleep != src->toggleSleep;
+    dst->toggleOneWayPlatforms = dst->toggleOneWayPlatforms != src->toggleOneWayPlatforms;
+
+}
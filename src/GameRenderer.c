@@ -0,0 +1,148 @@
+/**
+ * @file GameRenderer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief GameRenderer implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "GameRenderer.h"
+#include "Memory.h"
+#include "InstancedRenderer.h"
+#include "LabelCache.h"
+#include "GeometryBuffer.h"
+#include "StaticLayer.h"
+#include "TileMapRenderer.h"
+#include "RenderScaler.h"
+#include "GpuTimer.h"
+#include "ParticleSystem.h"
+
+#include "raylib/raylib.h"
+
+#define BOX_INSTANCES_CAPACITY 4096
+#define GEOMETRY_VERTICES_CAPACITY 65536
+
+// multisampling of a multisampled framebuffer can be switched off with
+// the OpenGL 1.1 glDisable, rlgl doesn't wrap it
+#if defined( _WIN32 ) && !defined( _WIN64 )
+    #define GAME_RENDERER_GL_API __stdcall
+#else
+    #define GAME_RENDERER_GL_API
+#endif
+
+#define GAME_RENDERER_GL_MULTISAMPLE 0x809D
+
+extern void GAME_RENDERER_GL_API glEnable( unsigned int cap );
+extern void GAME_RENDERER_GL_API glDisable( unsigned int cap );
+
+/**
+ * @brief Creates a dinamically allocated GameRenderer struct instance.
+ * Needs an OpenGL context.
+ */
+GameRenderer* createGameRenderer( void ) {
+
+    GameRenderer *gr = (GameRenderer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( GameRenderer ) );
+
+    gr->boxRenderer = createInstancedRenderer( BOX_INSTANCES_CAPACITY );
+    gr->instancing = true;
+
+    gr->labelCache = createLabelCache();
+    gr->showLabels = true;
+
+    gr->geometryBuffer = createGeometryBuffer( GEOMETRY_VERTICES_CAPACITY );
+    gr->streamGeometry = true;
+
+    gr->stencilFill = false;
+
+    gr->staticLayer = createStaticLayer();
+    gr->cacheStaticLayer = true;
+
+    gr->tileMapRenderer = createTileMapRenderer();
+
+    // same gravity as the world, 9.8 m/s^2 at 128 length units per meter
+    gr->particles = createParticleSystem( PARTICLE_SYSTEM_CAPACITY, 9.8f * 128.0f );
+    gr->impactAudio = NULL;
+    gr->audioService = NULL;
+
+    gr->scaler = createRenderScaler( 1.0f, false, 60 );
+
+    gr->antialiasing = ANTIALIASING_NONE;
+    gr->msaaAvailable = IsWindowState( FLAG_MSAA_4X_HINT );
+    gr->gpuTimer = createGpuTimer();
+
+    gr->drawTime = 0.0;
+
+    return gr;
+
+}
+
+/**
+ * @brief Selects the anti-aliasing mode. MSAA falls back to none when the
+ * window was not created multisampled.
+ */
+void setGameRendererAntialiasing( GameRenderer *gr, AntialiasingMode mode ) {
+
+    if ( mode == ANTIALIASING_MSAA_4X && !gr->msaaAvailable ) {
+        TraceLog( LOG_WARNING, "ANTIALIASING: window is not multisampled, MSAA not available" );
+        mode = ANTIALIASING_NONE;
+    }
+
+    if ( gr->gpuTimer->samples > 0 ) {
+        TraceLog( 
+            LOG_INFO, "ANTIALIASING: %s, average GPU frame time %.3fms over %d frames", 
+            getAntialiasingModeName( gr->antialiasing ), gr->gpuTimer->averageTime, gr->gpuTimer->samples 
+        );
+    }
+
+    if ( gr->msaaAvailable ) {
+        if ( mode == ANTIALIASING_MSAA_4X ) {
+            glEnable( GAME_RENDERER_GL_MULTISAMPLE );
+        } else {
+            glDisable( GAME_RENDERER_GL_MULTISAMPLE );
+        }
+    }
+
+    gr->scaler->fxaa = mode == ANTIALIASING_FXAA;
+    gr->antialiasing = mode;
+    resetGpuTimer( gr->gpuTimer );
+
+}
+
+/**
+ * @brief Returns the anti-aliasing mode the scene is actually drawn
+ * with: MSAA is lost when the scene goes to the scaled target.
+ */
+AntialiasingMode getGameRendererEffectiveAntialiasing( const GameRenderer *gr ) {
+    if ( gr->antialiasing == ANTIALIASING_MSAA_4X && gr->scaler->scale < RENDER_SCALE_MAX ) {
+        return ANTIALIASING_NONE;
+    }
+    return gr->antialiasing;
+}
+
+/**
+ * @brief Returns the name of an anti-aliasing mode.
+ */
+const char *getAntialiasingModeName( AntialiasingMode mode ) {
+    switch ( mode ) {
+        case ANTIALIASING_MSAA_4X: return "msaa 4x";
+        case ANTIALIASING_FXAA: return "fxaa";
+        default: return "none";
+    }
+}
+
+/**
+ * @brief Destroys a GameRenderer object and its GPU resources.
+ */
+void destroyGameRenderer( GameRenderer *gr ) {
+    destroyInstancedRenderer( gr->boxRenderer );
+    destroyLabelCache( gr->labelCache );
+    destroyGeometryBuffer( gr->geometryBuffer );
+    destroyStaticLayer( gr->staticLayer );
+    destroyTileMapRenderer( gr->tileMapRenderer );
+    destroyParticleSystem( gr->particles );
+    destroyRenderScaler( gr->scaler );
+    destroyGpuTimer( gr->gpuTimer );
+    freeMemory( gr );
+}
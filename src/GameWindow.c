@@ -9,7 +9,13 @@
 #include <stdbool.h>
 
 #include "GameWindow.h"
+#include "Memory.h"
 #include "GameWorld.h"
+#include "GameInput.h"
+#include "RenderPipeline.h"
+#include "GameRenderer.h"
+#include "StressScene.h"
+#include "RenderScaler.h"
 #include "ResourceManager.h"
 #include "raylib/raylib.h"
 
@@ -30,7 +36,7 @@ GameWindow* createGameWindow(
         bool loadResources, 
         bool initAudio ) {
 
-    GameWindow *gameWindow = (GameWindow*) malloc( sizeof( GameWindow ) );
+    GameWindow *gameWindow = (GameWindow*) allocMemory( MEMORY_SUBSYSTEM_WINDOW, sizeof( GameWindow ) );
 
     gameWindow->width = width;
     gameWindow->height = height;
@@ -45,6 +51,23 @@ GameWindow* createGameWindow(
     gameWindow->loadResources = loadResources;
     gameWindow->initAudio = initAudio;
     gameWindow->gw = NULL;
+    gameWindow->pipelined = false;
+    gameWindow->pipeline = NULL;
+    gameWindow->snapshot = NULL;
+    gameWindow->renderer = NULL;
+    gameWindow->impactAudio = NULL;
+    gameWindow->audioService = NULL;
+    gameWindow->musicFileName = NULL;
+    gameWindow->musicPlaying = false;
+    gameWindow->renderScale = 1.0f;
+    gameWindow->dynamicRenderScale = false;
+    gameWindow->antialiasingMode = antialiasing ? ANTIALIASING_MSAA_4X : ANTIALIASING_NONE;
+    gameWindow->useStressScene = false;
+    gameWindow->stressScene = (StressSceneConfig) { 100, 50, 16, 200, 1 };
+    gameWindow->stressReportFileName = NULL;
+    gameWindow->stressReport = (StressReport) { 0 };
+    gameWindow->useTileMap = false;
+    gameWindow->tileMap = (TileMapConfig) { NULL, 95, 51, 8.0f, 1, true };
     gameWindow->initialized = false;
 
     return gameWindow;
@@ -97,21 +120,158 @@ void initGameWindow( GameWindow *gameWindow ) {
             loadResourcesResourceManager();
         }
 
-        gameWindow->gw = createGameWorld();
+        gameWindow->renderer = createGameRenderer();
+        gameWindow->impactAudio = createImpactAudio( GetScreenWidth() );
+        gameWindow->renderer->impactAudio = gameWindow->impactAudio;
+        if ( IsAudioDeviceReady() ) {
+            gameWindow->audioService = createAudioService();
+            gameWindow->renderer->audioService = gameWindow->audioService;
+            if ( gameWindow->audioService != NULL && gameWindow->musicFileName != NULL ) {
+                gameWindow->musicPlaying = crossfadeAudioServiceMusic( gameWindow->audioService, gameWindow->musicFileName, 1.0f );
+            }
+        }
+        setGameWindowRenderScale( gameWindow, gameWindow->renderScale, gameWindow->dynamicRenderScale );
+        setGameWindowAntialiasingMode( gameWindow, gameWindow->antialiasingMode );
+        gameWindow->gw = createGameWorld( GetScreenWidth(), GetScreenHeight() );
+        int stressLevel = addGameWorldLevel( 
+            gameWindow->gw, 
+            &(LevelDef){ .name = "stress", .dummyObstacles = true, .stressScene = true, .stressSceneConfig = gameWindow->stressScene } 
+        );
+        int tileMapLevel = addGameWorldLevel( 
+            gameWindow->gw, 
+            &(LevelDef){ .name = "tiles", .tileMap = true, .tileMapConfig = gameWindow->tileMap } 
+        );
+        if ( gameWindow->useStressScene ) {
+            loadGameWorldLevel( gameWindow->gw, stressLevel );
+        } else if ( gameWindow->useTileMap ) {
+            loadGameWorldLevel( gameWindow->gw, tileMapLevel );
+        }
+        gameWindow->snapshot = (RenderSnapshot*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( RenderSnapshot ) );
+        gameWindow->snapshot->capturedTick = -1;
+        gameWindow->snapshot->obstaclesQuantity = 0;
+        gameWindow->snapshot->chainObstacleQuantity = 0;
+
+        if ( gameWindow->pipelined ) {
+            gameWindow->pipeline = createRenderPipeline( gameWindow->gw );
+            gameWindow->pipelined = gameWindow->pipeline != NULL;
+        }
 
         // game loop
         while ( !WindowShouldClose() ) {
-            updateGameWorld( gameWindow->gw, GetFrameTime() );
-            drawGameWorld( gameWindow->gw );
+
+            beginMemoryFrame();
+
+            if ( IsKeyPressed( KEY_F5 ) ) {
+                setGameWindowPipelined( gameWindow, !gameWindow->pipelined );
+            }
+
+            if ( IsKeyPressed( KEY_F6 ) ) {
+                gameWindow->renderer->instancing = !gameWindow->renderer->instancing;
+            }
+
+            if ( IsKeyPressed( KEY_F7 ) ) {
+                gameWindow->renderer->showLabels = !gameWindow->renderer->showLabels;
+            }
+
+            if ( IsKeyPressed( KEY_F8 ) ) {
+                gameWindow->renderer->streamGeometry = !gameWindow->renderer->streamGeometry;
+            }
+
+            if ( IsKeyPressed( KEY_F9 ) ) {
+                gameWindow->renderer->stencilFill = !gameWindow->renderer->stencilFill;
+            }
+
+            if ( IsKeyPressed( KEY_F10 ) ) {
+                gameWindow->renderer->cacheStaticLayer = !gameWindow->renderer->cacheStaticLayer;
+                invalidateStaticLayer( gameWindow->renderer->staticLayer );
+            }
+
+            // 100% -> 75% -> 50% -> dynamic -> 100%
+            if ( IsKeyPressed( KEY_F11 ) ) {
+                if ( gameWindow->dynamicRenderScale ) {
+                    setGameWindowRenderScale( gameWindow, 1.0f, false );
+                } else if ( gameWindow->renderScale <= 0.5f ) {
+                    setGameWindowRenderScale( gameWindow, 1.0f, true );
+                } else {
+                    setGameWindowRenderScale( gameWindow, gameWindow->renderScale - 0.25f, false );
+                }
+            }
+
+            // none -> MSAA (when multisampled) -> FXAA -> none
+            if ( IsKeyPressed( KEY_TAB ) ) {
+                AntialiasingMode mode = ( gameWindow->antialiasingMode + 1 ) % 3;
+                if ( mode == ANTIALIASING_MSAA_4X && !gameWindow->renderer->msaaAvailable ) {
+                    mode = ANTIALIASING_FXAA;
+                }
+                setGameWindowAntialiasingMode( gameWindow, mode );
+            }
+
+            if ( IsKeyPressed( KEY_M ) && gameWindow->audioService != NULL && gameWindow->musicFileName != NULL ) {
+                if ( gameWindow->musicPlaying ) {
+                    stopAudioServiceMusic( gameWindow->audioService, 1.0f );
+                    gameWindow->musicPlaying = false;
+                } else {
+                    gameWindow->musicPlaying = crossfadeAudioServiceMusic( gameWindow->audioService, gameWindow->musicFileName, 1.0f );
+                }
+            }
+
+            updateRenderScale( gameWindow->renderer->scaler, GetFrameTime() );
+
+            GameInput input = readGameInput();
+
+            RenderSnapshot *drawn = gameWindow->snapshot;
+            double captureTime = 0.0;
+
+            if ( gameWindow->pipeline != NULL ) {
+                submitRenderPipelineInput( gameWindow->pipeline, &input, GetFrameTime() );
+                drawn = acquireRenderPipelineSnapshot( gameWindow->pipeline );
+                drawGameWorld( drawn, gameWindow->renderer );
+            } else {
+                double start = GetTime();
+                updateGameWorld( gameWindow->gw, &input, GetFrameTime() );
+                double captureStart = GetTime();
+                captureRenderSnapshot( gameWindow->gw, gameWindow->snapshot );
+                captureTime = ( GetTime() - captureStart ) * 1000.0;
+                gameWindow->snapshot->pipelined = false;
+                gameWindow->snapshot->updateTime = ( GetTime() - start ) * 1000.0;
+                drawGameWorld( gameWindow->snapshot, gameWindow->renderer );
+            }
+
+            updateImpactAudio( gameWindow->impactAudio, drawn );
+            if ( gameWindow->audioService != NULL ) {
+                updateAudioService( gameWindow->audioService );
+            }
+
+            if ( gameWindow->stressReportFileName != NULL ) {
+                addStressReportSample( 
+                    &gameWindow->stressReport, GetFrameTime() * 1000.0, drawn->updateTime - captureTime, 
+                    drawn->stepTime, captureTime, gameWindow->renderer->drawTime, gameWindow->renderer->gpuTimer->lastTime 
+                );
+            }
+
+            endMemoryFrame();
+
+        }
+
+        logMemoryReport();
+
+        if ( gameWindow->stressReportFileName != NULL ) {
+            writeStressReport( 
+                gameWindow->stressReportFileName, gameWindow->pipelined ? "pipelined" : "serial", 
+                &gameWindow->stressScene, gameWindow->gw, &gameWindow->stressReport 
+            );
         }
 
+        setGameWindowPipelined( gameWindow, false );
+
         if ( gameWindow->loadResources ) {
             unloadResourcesResourceManager();
         }
 
+        bool initAudio = gameWindow->initAudio;
         destroyGameWindow( gameWindow );
 
-        if ( gameWindow->initAudio ) {
+        if ( initAudio ) {
             CloseAudioDevice();
         }
 
@@ -121,10 +281,102 @@ void initGameWindow( GameWindow *gameWindow ) {
 
 }
 
+/**
+ * @brief Switches between serial and pipelined simulation/rendering.
+ */
+void setGameWindowPipelined( GameWindow *gameWindow, bool pipelined ) {
+
+    gameWindow->pipelined = pipelined;
+
+    if ( pipelined && gameWindow->pipeline == NULL && gameWindow->gw != NULL ) {
+        gameWindow->pipeline = createRenderPipeline( gameWindow->gw );
+        // without the thread the frames stay serial
+        gameWindow->pipelined = gameWindow->pipeline != NULL;
+    } else if ( !pipelined && gameWindow->pipeline != NULL ) {
+        destroyRenderPipeline( gameWindow->pipeline );
+        gameWindow->pipeline = NULL;
+    }
+
+}
+
+/**
+ * @brief Sets the internal resolution scale of the scene, from 0.5 to 1.
+ * When dynamic, the scale starts there and follows the frame time
+ * budget of the target FPS.
+ */
+void setGameWindowRenderScale( GameWindow *gameWindow, float scale, bool dynamic ) {
+
+    gameWindow->renderScale = scale;
+    gameWindow->dynamicRenderScale = dynamic;
+
+    if ( gameWindow->renderer != NULL ) {
+        RenderScaler *rsc = gameWindow->renderer->scaler;
+        setRenderScale( rsc, scale );
+        rsc->dynamic = dynamic;
+        rsc->frameBudget = 1.0f / ( gameWindow->targetFPS > 0 ? gameWindow->targetFPS : 60 );
+        rsc->overBudgetFrames = 0;
+        rsc->withinBudgetFrames = 0;
+    }
+
+}
+
+/**
+ * @brief Selects the anti-aliasing mode. MSAA is only available if the
+ * window was created with antialiasing.
+ */
+void setGameWindowAntialiasingMode( GameWindow *gameWindow, AntialiasingMode mode ) {
+
+    gameWindow->antialiasingMode = mode;
+
+    if ( gameWindow->renderer != NULL ) {
+        setGameRendererAntialiasing( gameWindow->renderer, mode );
+        gameWindow->antialiasingMode = gameWindow->renderer->antialiasing;
+    }
+
+}
+
+/**
+ * @brief Adds a generated stress scene to the world. Must be called
+ * before initGameWindow. When reportFileName is not NULL, the average
+ * timings of the run are appended to it when the window is closed.
+ */
+void setGameWindowStressScene( GameWindow *gameWindow, const StressSceneConfig *config, const char *reportFileName ) {
+    gameWindow->useStressScene = true;
+    gameWindow->stressScene = *config;
+    gameWindow->stressReportFileName = reportFileName;
+}
+
+/**
+ * @brief Starts with the tile map level, imported or generated from
+ * config. Must be called before initGameWindow.
+ */
+void setGameWindowTileMap( GameWindow *gameWindow, const TileMapConfig *config ) {
+    gameWindow->useTileMap = true;
+    gameWindow->tileMap = *config;
+}
+
+/**
+ * @brief Streams a music file while the window is open. Must be called
+ * before initGameWindow.
+ */
+void setGameWindowMusic( GameWindow *gameWindow, const char *fileName ) {
+    gameWindow->musicFileName = fileName;
+}
+
 /**
  * @brief Destroys a GameWindow object and its dependecies.
  */
 void destroyGameWindow( GameWindow *gameWindow ) {
     destroyGameWorld( gameWindow->gw );
-    free( gameWindow );
+    if ( gameWindow->renderer != NULL ) {
+        destroyGameRenderer( gameWindow->renderer );
+    }
+    if ( gameWindow->impactAudio != NULL ) {
+        destroyImpactAudio( gameWindow->impactAudio );
+    }
+    if ( gameWindow->audioService != NULL ) {
+        destroyAudioService( gameWindow->audioService );
+    }
+    freeMemory( gameWindow->snapshot );
+    freeMemory( gameWindow );
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "GameWorld.h"
@@ -15,6 +16,24 @@
 #include "Player.h"
 #include "Obstacle.h"
 #include "ChainObstacle.h"
+#include "SpatialQuery.h"
+#include "PhysicsLOD.h"
+#include "SleepManager.h"
+#include "TerrainCarver.h"
+#include "OneWayPlatform.h"
+#include "GameInput.h"
+#include "GameRenderer.h"
+#include "InstancedRenderer.h"
+#include "LabelCache.h"
+#include "GeometryBuffer.h"
+#include "StaticLayer.h"
+#include "TileMap.h"
+#include "TileMapRenderer.h"
+#include "ParticleSystem.h"
+#include "RenderScaler.h"
+#include "DrawingUtils.h"
+#include "Memory.h"
+#include "StressScene.h"
 
 #include "raylib/raylib.h"
 #include "raylib/rlgl.h"
@@ -28,106 +47,602 @@
 b2Vec2 creationPoints[MAX_CHAIN_OBSTACLE_POINTS];
 int creationPointsQ = 0;
 
+// particles of the bursts, scaled by the speed of the contacts
+#define PARTICLE_CONTACT_MIN_SPEED 64.0f
+#define PARTICLE_SPEED_PER_PARTICLE 16.0f
+#define PARTICLE_MAX_BURST 128
+#define PARTICLE_FOUNTAIN_QUANTITY 2500
+
+// holds the world and the per level allocations, it is kept between
+// levels so loading one doesn't touch the heap
+static MemoryArena *levelArena = NULL;
+
 /**
- * @brief Creates a dinamically allocated GameWorld struct instance.
+ * @brief Creates a GameWorld struct instance with a walled area of
+ * width x height, allocated from the level arena, and loads its default
+ * level. Only one world can exist at a time.
  */
-GameWorld* createGameWorld( void ) {
+GameWorld* createGameWorld( float width, float height ) {
 
     SetExitKey( KEY_NULL );
-    GameWorld *gw = (GameWorld*) malloc( sizeof( GameWorld ) );
+
+    if ( levelArena == NULL ) {
+        levelArena = createMemoryArena( MEMORY_SUBSYSTEM_WORLD, sizeof( GameWorld ) + LEVEL_ARENA_EXTRA_CAPACITY );
+    }
+    resetMemoryArena( levelArena );
+
+    GameWorld *gw = (GameWorld*) allocMemoryArena( levelArena, sizeof( GameWorld ), 16 );
+    gw->levelArena = levelArena;
+    gw->width = width;
+    gw->height = height;
 
     float lengthUnitsPerMeter = 128.0f;
 	b2SetLengthUnitsPerMeter( lengthUnitsPerMeter );
 
+    float activeMargin = 100.0f;
+    initSleepManager( 
+        &gw->sleep, 
+        (Rectangle){ -activeMargin, -activeMargin, width + activeMargin * 2, height + activeMargin * 2 },
+        80.0f, 64 );
+
     gw->worldDef = b2DefaultWorldDef();
     gw->worldDef.gravity = (b2Vec2){ 0.0f, 9.8f * lengthUnitsPerMeter };
+    gw->worldDef.enableSleep = gw->sleep.enableSleep;
     gw->worldId = b2CreateWorld( &gw->worldDef );
 
     gw->obstaclesQuantity = 0;
     gw->chainObstacleQuantity = 0;
+    gw->tileMap.loaded = false;
+    gw->tileMap.revision = 0;
+    gw->tileMap.columns = 0;
+    gw->tileMap.rows = 0;
+
+    initPhysicsLOD( &gw->lod, 500.0f, 900.0f, 25.0f, 64 );
+    initSpatialQueryService( &gw->queryService, 32.0f, 4 );
+    initTerrainCarver( &gw->carver, 8 );
+    initOneWayPlatforms( &gw->oneWayPlatforms, gw->worldId );
+    gw->lineOfSightQuery = -1;
+    gw->showDebugInfo = false;
+    gw->tick = 0;
+    gw->refreshedTransforms = 0;
+    gw->staticRevision = 0;
+    gw->stepTime = 0.0f;
+
+    gw->solidChainObstacles = false;
+    gw->particleEmitterTotal = 0;
+    gw->impactTotal = 0;
+    gw->levelQuantity = 0;
+    gw->currentLevel = -1;
+    gw->levelLoaded = false;
+    gw->levelLoadTime = 0.0f;
+    gw->levelUnloadTime = 0.0f;
+
+    addGameWorldLevel( gw, &(LevelDef){ .name = "default", .dummyObstacles = true } );
+    loadGameWorldLevel( gw, 0 );
 
-    createPlayer( &gw->player, GetScreenWidth() / 2 - 150, GetScreenHeight() / 2, 40, 40, BLUE, gw );
+    return gw;
 
-    createObstacle( 10, GetScreenHeight() / 2, 20, GetScreenHeight() - 40, ORANGE, gw );
-    createObstacle( GetScreenWidth() - 10, GetScreenHeight() / 2, 20, GetScreenHeight() - 40, ORANGE, gw );
-    createObstacle( GetScreenWidth() / 2, 10, GetScreenWidth(), 20, ORANGE, gw );
-    createObstacle( GetScreenWidth() / 2, GetScreenHeight() - 10, GetScreenWidth(), 20, ORANGE, gw );
+}
 
-    createDummyObstcales( gw );
+/**
+ * @brief Destroys a GameWorld object and its Box2D world, releasing the
+ * level arena.
+ */
+void destroyGameWorld( GameWorld *gw ) {
+    destroySpatialQueryService( &gw->queryService );
+    b2DestroyWorld( gw->worldId );
+    resetMemoryArena( gw->levelArena );
+}
 
-    return gw;
+/**
+ * @brief Registers a level. Returns its index or -1 if there is no room.
+ */
+int addGameWorldLevel( GameWorld *gw, const LevelDef *level ) {
+
+    if ( gw->levelQuantity >= MAX_LEVELS ) {
+        TraceLog( LOG_WARNING, "LEVEL: no room for the level %s", level->name );
+        return -1;
+    }
+
+    gw->levels[gw->levelQuantity] = *level;
+
+    return gw->levelQuantity++;
 
 }
 
 /**
- * @brief Destroys a GameWindow object and its dependecies.
+ * @brief Loads a registered level, unloading the current one first. The
+ * entity arrays, the Box2D world pools and the renderer resources of the
+ * previous level are reused.
  */
-void destroyGameWorld( GameWorld *gw ) {
-    free( gw );
+bool loadGameWorldLevel( GameWorld *gw, int index ) {
+
+    if ( index < 0 || index >= gw->levelQuantity ) {
+        TraceLog( LOG_WARNING, "LEVEL: invalid level %d", index );
+        return false;
+    }
+
+    unloadGameWorldLevel( gw );
+
+    uint64_t ticks = b2GetTicks();
+    const LevelDef *level = &gw->levels[index];
+    float width = gw->width;
+    float height = gw->height;
+
+    // a new tick, so the snapshots captured from the previous level see
+    // every entity as changed
+    gw->tick++;
+    gw->currentLevel = index;
+    gw->lod.cursor = 0;
+    gw->sleep.cursor = 0;
+
+    createPlayer( &gw->player, width / 2 - 150, height / 2, 40, 40, BLUE, gw );
+
+    createObstacle( 10, height / 2, 20, height - 40, ORANGE, SHAPE_FLAG_NONE, gw );
+    createObstacle( width - 10, height / 2, 20, height - 40, ORANGE, SHAPE_FLAG_NONE, gw );
+    createObstacle( width / 2, 10, width, 20, ORANGE, SHAPE_FLAG_NONE, gw );
+    createObstacle( width / 2, height - 10, width, 20, ORANGE, SHAPE_FLAG_NONE, gw );
+
+    if ( level->dummyObstacles ) {
+        createDummyObstcales( gw );
+    }
+
+    if ( level->stressScene ) {
+        generateStressScene( gw, &level->stressSceneConfig );
+    }
+
+    if ( level->tileMap ) {
+        loadTileMap( gw, &level->tileMapConfig );
+    }
+
+    gw->levelLoaded = true;
+    gw->levelLoadTime = b2GetMilliseconds( ticks );
+
+    // Box2D may still grow its pools for a larger level
+    restartMemoryWarmUp();
+
+    TraceLog( 
+        LOG_INFO, "LEVEL: %s loaded in %.3fms (unload %.3fms)", 
+        level->name, gw->levelLoadTime, gw->levelUnloadTime 
+    );
+
+    return true;
+
 }
 
 /**
- * @brief Reads user input and updates the state of the game.
+ * @brief Removes the bodies of the current level. The Box2D world is
+ * kept, so its pools keep their capacity for the next level.
  */
-void updateGameWorld( GameWorld *gw, float delta ) {
+void unloadGameWorldLevel( GameWorld *gw ) {
 
-    updatePlayer( &gw->player );
-    handleChainObjectCreation( gw );
+    if ( !gw->levelLoaded ) {
+        return;
+    }
+
+    uint64_t ticks = b2GetTicks();
+
+    // the chains are destroyed with their bodies
+    b2DestroyBody( gw->player.bodyId );
+    for ( int i = 0; i < gw->obstaclesQuantity; i++ ) {
+        b2DestroyBody( gw->obstacles[i].bodyId );
+    }
+    for ( int i = 0; i < gw->chainObstacleQuantity; i++ ) {
+        b2DestroyBody( gw->chainObstacles[i].bodyId );
+    }
+    unloadTileMap( gw );
+
+    gw->obstaclesQuantity = 0;
+    gw->chainObstacleQuantity = 0;
+    gw->oneWayPlatforms.stats.platformShapes = 0;
+    gw->lineOfSightQuery = -1;
+    clearSpatialQueryCache( &gw->queryService );
+    clearTerrainCarver( &gw->carver );
+    creationPointsQ = 0;
+
+    gw->staticRevision++;
+    gw->levelLoaded = false;
+    gw->levelUnloadTime = b2GetMilliseconds( ticks );
+
+}
+
+/**
+ * @brief Loads the current level again, e.g. for a restart.
+ */
+void reloadGameWorldLevel( GameWorld *gw ) {
+    if ( gw->currentLevel >= 0 ) {
+        loadGameWorldLevel( gw, gw->currentLevel );
+    }
+}
+
+/**
+ * @brief Switches to the level that comes offset levels after the
+ * current one, wrapping around.
+ */
+void switchGameWorldLevel( GameWorld *gw, int offset ) {
+    if ( gw->levelQuantity > 0 ) {
+        int index = ( ( gw->currentLevel + offset ) % gw->levelQuantity + gw->levelQuantity ) % gw->levelQuantity;
+        loadGameWorldLevel( gw, index );
+    }
+}
+
+/**
+ * @brief Applies user input and updates the state of the game.
+ */
+void updateGameWorld( GameWorld *gw, const GameInput *input, float delta ) {
+
+    gw->tick++;
+
+    if ( input->toggleDebugInfo ) {
+        gw->showDebugInfo = !gw->showDebugInfo;
+    }
+
+    if ( input->toggleParallelQueries ) {
+        gw->queryService.parallel = !gw->queryService.parallel;
+    }
+
+    if ( input->togglePhysicsLOD ) {
+        setPhysicsLODEnabled( &gw->lod, gw, !gw->lod.enabled );
+    }
+
+    if ( input->toggleSleep ) {
+        gw->sleep.enableSleep = !gw->sleep.enableSleep;
+        b2World_EnableSleeping( gw->worldId, gw->sleep.enableSleep );
+    }
+
+    if ( input->toggleOneWayPlatforms ) {
+        setOneWayPlatformsEnabled( &gw->oneWayPlatforms, gw->worldId, !gw->oneWayPlatforms.stats.enabled );
+    }
+
+    // the representation of the chains changes when they are created
+    if ( input->toggleSolidChains ) {
+        gw->solidChainObstacles = !gw->solidChainObstacles;
+    }
+
+    if ( input->reloadLevel || input->toggleSolidChains ) {
+        reloadGameWorldLevel( gw );
+    } else if ( input->nextLevel ) {
+        switchGameWorldLevel( gw, 1 );
+    }
+
+    beginSpatialQueryTick( &gw->queryService );
+
+    updatePlayer( &gw->player, input );
+    handleChainObjectCreation( gw, input );
+    handleDynamicObstacleCreation( gw, input );
+
+    if ( input->emitParticles ) {
+        addParticleEmitter( 
+            gw, (b2Vec2){ input->mousePosition.x, input->mousePosition.y }, 
+            (b2Vec2){ 0.0f, -1.0f }, 700.0f, PARTICLE_FOUNTAIN_QUANTITY, SKYBLUE 
+        );
+    }
+
+    if ( input->carveTerrain ) {
+        requestCircleCarve( &gw->carver, (b2Vec2){ input->mousePosition.x, input->mousePosition.y }, TERRAIN_CARVER_RADIUS );
+    }
+    updateTerrainCarver( &gw->carver, gw );
+
+    updatePhysicsLOD( &gw->lod, gw, b2Body_GetPosition( gw->player.bodyId ) );
+    updateSleepManager( &gw->sleep, gw, b2Body_GetPosition( gw->player.bodyId ) );
+    requestLineOfSight( gw, input );
 
     int subStepCount = 4;
     b2World_Step( gw->worldId, delta, subStepCount );
+    gw->stepTime = b2World_GetProfile( gw->worldId ).step;
+    updateOneWayPlatformStats( &gw->oneWayPlatforms, gw->worldId );
     handleContactEvents( gw );
+    syncRenderTransforms( gw );
+
+    executeSpatialQueries( &gw->queryService, gw->worldId );
 
 }
 
 /**
- * @brief Draws the state of the game.
+ * @brief Copies the render relevant state of the game into a snapshot.
  */
-void drawGameWorld( GameWorld *gw ) {
+void captureRenderSnapshot( GameWorld *gw, RenderSnapshot *rs ) {
 
-    BeginDrawing();
-    ClearBackground( WHITE );
-
-    drawPlayer( &gw->player );
+    int copied = 1;
+    rs->player = gw->player;
 
     for ( int i = 0; i < gw->obstaclesQuantity; i++ ) {
-        drawObstacle( &gw->obstacles[i] );
+        if ( i >= rs->obstaclesQuantity || gw->obstacles[i].changedTick > rs->capturedTick ) {
+            rs->obstacles[i] = gw->obstacles[i];
+            copied++;
+        }
     }
+    rs->obstaclesQuantity = gw->obstaclesQuantity;
 
     for ( int i = 0; i < gw->chainObstacleQuantity; i++ ) {
-        drawChainObstacle( &gw->chainObstacles[i] );
+        if ( i >= rs->chainObstacleQuantity || gw->chainObstacles[i].changedTick > rs->capturedTick ) {
+            rs->chainObstacles[i] = gw->chainObstacles[i];
+            copied++;
+        }
+    }
+    rs->chainObstacleQuantity = gw->chainObstacleQuantity;
+
+    copyTileMap( &rs->tileMap, &gw->tileMap, rs->capturedTick < 0 );
+
+    rs->stepTime = gw->stepTime;
+    rs->levelName = gw->currentLevel >= 0 ? gw->levels[gw->currentLevel].name : "";
+    rs->solidChainObstacles = gw->solidChainObstacles;
+    rs->levelLoadTime = gw->levelLoadTime;
+    rs->levelUnloadTime = gw->levelUnloadTime;
+    rs->capturedTick = gw->tick;
+    rs->refreshedTransforms = gw->refreshedTransforms;
+    rs->copiedEntities = copied;
+
+    rs->creationPointsQ = creationPointsQ;
+    for ( int i = 0; i < creationPointsQ; i++ ) {
+        rs->creationPoints[i] = creationPoints[i];
+    }
+
+    rs->showDebugInfo = gw->showDebugInfo;
+    rs->staticRevision = gw->staticRevision;
+
+    const SpatialQueryResult *r = getSpatialQueryResult( &gw->queryService, gw->lineOfSightQuery );
+    rs->lineOfSightValid = r != NULL;
+    if ( r != NULL ) {
+        rs->lineOfSightHit = r->hit;
+        rs->lineOfSightOrigin = gw->player.position;
+        rs->lineOfSightEnd = r->hit ? r->point : gw->lineOfSightTarget;
     }
 
-    for ( int i = 0; i < creationPointsQ - 1; i++ ) {
+    rs->queryStats = gw->queryService.stats;
+    rs->lod = gw->lod;
+    rs->sleep = gw->sleep;
+    rs->carver = gw->carver;
+    rs->oneWayPlatforms = gw->oneWayPlatforms.stats;
+
+    // the ring only holds the last bursts, older ones are lost anyway
+    int firstEmitter = rs->capturedTick < 0 ? 0 : rs->particleEmitterTotal;
+    if ( firstEmitter > gw->particleEmitterTotal || gw->particleEmitterTotal - firstEmitter > PARTICLE_EMITTER_HISTORY ) {
+        firstEmitter = b2MaxInt( gw->particleEmitterTotal - PARTICLE_EMITTER_HISTORY, 0 );
+    }
+    for ( int i = firstEmitter; i < gw->particleEmitterTotal; i++ ) {
+        rs->particleEmitters[i % PARTICLE_EMITTER_HISTORY] = gw->particleEmitters[i % PARTICLE_EMITTER_HISTORY];
+    }
+    rs->particleEmitterTotal = gw->particleEmitterTotal;
+
+    int firstImpact = rs->capturedTick < 0 ? 0 : rs->impactTotal;
+    if ( firstImpact > gw->impactTotal || gw->impactTotal - firstImpact > IMPACT_HISTORY ) {
+        firstImpact = b2MaxInt( gw->impactTotal - IMPACT_HISTORY, 0 );
+    }
+    for ( int i = firstImpact; i < gw->impactTotal; i++ ) {
+        rs->impacts[i % IMPACT_HISTORY] = gw->impacts[i % IMPACT_HISTORY];
+    }
+    rs->impactTotal = gw->impactTotal;
+
+}
+
+/**
+ * @brief Draws a snapshot of the state of the game.
+ */
+void drawGameWorld( RenderSnapshot *rs, GameRenderer *gr ) {
+
+    double start = GetTime();
+
+    BeginDrawing();
+    beginGpuTimer( gr->gpuTimer );
+
+    InstancedRenderer *ir = gr->boxRenderer;
+    GeometryBuffer *gb = gr->geometryBuffer;
+    beginInstancedFrame( ir );
+    beginGeometryFrame( gb );
+
+    bool cached = gr->cacheStaticLayer;
+
+    updateTileMapRenderer( gr->tileMapRenderer, &rs->tileMap );
+
+    // particles never touch the Box2D world, they only follow the frames
+    emitSnapshotParticles( gr->particles, rs );
+    updateParticleSystem( gr->particles, GetFrameTime() );
+
+    // texture modes don't nest, so the caches are updated before the
+    // scene starts
+    if ( cached ) {
+        updateStaticLayer( gr->staticLayer, rs, gr->showLabels );
+    } else if ( gr->showLabels ) {
+        updateLabelCache( gr->labelCache, rs );
+    }
+
+    beginScaledScene( gr->scaler, WHITE );
+
+    // the offscreen target has no stencil attachment
+    bool stencil = gr->stencilFill && !gr->scaler->active;
+
+    drawTileMapRenderer( gr->tileMapRenderer, &rs->tileMap );
+
+    // the static entities go under the dynamic ones, either from the
+    // cached tiles or drawn every frame
+    if ( cached ) {
+        drawStaticLayer( gr->staticLayer );
+    } else {
+
+        setDrawingGeometryBuffer( gr->streamGeometry ? gb : NULL );
+        setConcaveFillMode( stencil ? CONCAVE_FILL_STENCIL : CONCAVE_FILL_TRIANGULATE );
+        if ( stencil ) {
+            clearStencilBuffer();
+        }
+
+        for ( int i = 0; i < rs->chainObstacleQuantity; i++ ) {
+            drawChainObstacle( &rs->chainObstacles[i] );
+        }
+
+        flushGeometryBuffer( gb );
+        setDrawingGeometryBuffer( NULL );
+        setConcaveFillMode( CONCAVE_FILL_TRIANGULATE );
+
+    }
+
+    if ( gr->instancing ) {
+        Player *p = &rs->player;
+        addBoxInstance( ir, p->position, p->rotation, p->dim, p->color );
+        for ( int i = 0; i < rs->obstaclesQuantity; i++ ) {
+            Obstacle *o = &rs->obstacles[i];
+            if ( !cached || o->dynamic ) {
+                addBoxInstance( ir, o->position, o->rotation, o->dim, o->color );
+            }
+        }
+        flushBoxInstances( ir );
+    } else {
+        drawPlayer( &rs->player );
+        for ( int i = 0; i < rs->obstaclesQuantity; i++ ) {
+            if ( !cached || rs->obstacles[i].dynamic ) {
+                drawObstacle( &rs->obstacles[i] );
+            }
+        }
+    }
+
+    drawParticleSystem( gr->particles );
+
+    if ( gr->showLabels && !cached ) {
+        drawLabelCache( gr->labelCache );
+    }
+
+    for ( int i = 0; i < rs->creationPointsQ - 1; i++ ) {
         DrawLine( 
-            creationPoints[i].x,
-            creationPoints[i].y,
-            creationPoints[i+1].x,
-            creationPoints[i+1].y,
+            rs->creationPoints[i].x,
+            rs->creationPoints[i].y,
+            rs->creationPoints[i+1].x,
+            rs->creationPoints[i+1].y,
             GREEN
         );
     }
 
+    if ( rs->showDebugInfo ) {
+        drawLineOfSight( rs );
+    }
+
+    endScaledScene( gr->scaler );
+
+    if ( rs->showDebugInfo ) {
+        drawSpatialQueryStats( &rs->queryStats, 30, 50 );
+        drawPhysicsLODStats( &rs->lod, 30, 74 );
+        drawSleepStats( &rs->sleep, 30, 86 );
+        DrawText( 
+            TextFormat( 
+                "%s update: %.3fms step: %.3fms draw: %.3fms", 
+                rs->pipelined ? "pipelined" : "serial", rs->updateTime, rs->stepTime, gr->drawTime 
+            ), 
+            30, 98, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( "transforms refreshed: %d entities copied: %d", rs->refreshedTransforms, rs->copiedEntities ), 
+            30, 110, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( 
+                "boxes %s: %d drawn, %d culled, %d draw calls", 
+                gr->instancing ? "instanced" : "immediate",
+                ir->drawnInstances, ir->culledInstances, ir->drawCalls
+            ), 
+            30, 122, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( "labels %s: %d cache rebuilds", gr->showLabels ? "on" : "off", gr->labelCache->rebuilds ), 
+            30, 134, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( 
+                "geometry %s, %s fill: %d vertices, %d flushes (peak %d)", 
+                gr->streamGeometry ? "streamed" : "immediate",
+                stencil ? "stencil" : "triangulated",
+                gb->frameVertices, gb->frameFlushes, gb->peakFrameVertices
+            ), 
+            30, 146, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( 
+                "static layer %s: %d tiles drawn, %d rebuilt (%d total)", 
+                cached ? "cached" : "immediate",
+                gr->staticLayer->drawnTiles, gr->staticLayer->rebuiltTiles, gr->staticLayer->totalRebuilds
+            ), 
+            30, 158, 10, DARKGRAY 
+        );
+        DrawText( 
+            TextFormat( 
+                "render scale %d%% %s", 
+                (int) roundf( gr->scaler->scale * 100 ),
+                gr->scaler->dynamic ? "dynamic" : "fixed"
+            ), 
+            30, 170, 10, DARKGRAY 
+        );
+        AntialiasingMode antialiasing = getGameRendererEffectiveAntialiasing( gr );
+        const char *antialiasingName = antialiasing == gr->antialiasing ? 
+            getAntialiasingModeName( antialiasing ) : 
+            TextFormat( "%s (selected %s, not multisampled below full scale)", 
+                        getAntialiasingModeName( antialiasing ), getAntialiasingModeName( gr->antialiasing ) );
+        if ( gr->gpuTimer->ready ) {
+            DrawText( 
+                TextFormat( 
+                    "antialiasing %s: gpu %.3fms (avg %.3fms over %d frames)", 
+                    antialiasingName,
+                    gr->gpuTimer->lastTime, gr->gpuTimer->averageTime, gr->gpuTimer->samples
+                ), 
+                30, 182, 10, DARKGRAY 
+            );
+        } else {
+            DrawText( 
+                TextFormat( "antialiasing %s: gpu time not available", antialiasingName ), 
+                30, 182, 10, DARKGRAY 
+            );
+        }
+        drawMemoryStats( 30, 194 );
+        DrawText( 
+            TextFormat( 
+                "level %s: load %.3fms unload %.3fms, %s chains (R: restart, N: next level, C: chain mode)", 
+                rs->levelName, rs->levelLoadTime, rs->levelUnloadTime, rs->solidChainObstacles ? "solid" : "hollow"
+            ), 
+            30, 206, 10, DARKGRAY 
+        );
+        if ( rs->tileMap.loaded ) {
+            TileMapRenderer *tmr = gr->tileMapRenderer;
+            DrawText( 
+                TextFormat( 
+                    "tile map %dx%d: %d solid tiles in %d rectangles and %d chains (%.3fms), %d chunks drawn, %d culled, %d vertices", 
+                    rs->tileMap.columns, rs->tileMap.rows, rs->tileMap.solidTiles, 
+                    rs->tileMap.rectangleQuantity, rs->tileMap.chainQuantity, rs->tileMap.buildTime,
+                    tmr->drawnChunks, tmr->culledChunks, tmr->drawnVertices
+                ), 
+                30, 218, 10, DARKGRAY 
+            );
+        }
+        drawTerrainCarverStats( &rs->carver, 30, 230 );
+        drawParticleStats( gr->particles, 30, 242 );
+        if ( gr->impactAudio != NULL ) {
+            drawImpactAudioStats( gr->impactAudio, 30, 254 );
+        }
+        if ( gr->audioService != NULL ) {
+            drawAudioServiceStats( gr->audioService, 30, 266 );
+        }
+        drawOneWayPlatformStats( &rs->oneWayPlatforms, 30, 278 );
+    }
+
     DrawFPS( 30, 30 );
 
+    endGpuTimer( gr->gpuTimer );
+    gr->drawTime = ( GetTime() - start ) * 1000.0;
+
     EndDrawing();
 
 }
 
-void handleChainObjectCreation( GameWorld *gw ) {
+void handleChainObjectCreation( GameWorld *gw, const GameInput *input ) {
 
-    if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
+    if ( input->addChainPoint ) {
         if ( creationPointsQ < MAX_CHAIN_OBSTACLE_POINTS ) {
             int p = creationPointsQ;
-            creationPoints[p].x = GetMouseX();
-            creationPoints[p].y = GetMouseY();
+            creationPoints[p].x = input->mousePosition.x;
+            creationPoints[p].y = input->mousePosition.y;
             creationPointsQ++;
         }
     }
 
-    if ( IsKeyPressed( KEY_ENTER ) ) {
+    if ( input->finishChain ) {
         if ( creationPointsQ > 3 && creationPointsQ < MAX_CHAIN_OBSTACLE_POINTS ) {
-            createChainObstacle( creationPoints, creationPointsQ, BLACK, true, gw );
+            createChainObstacle( creationPoints, creationPointsQ, BLACK, true, SHAPE_FLAG_NONE, gw );
             for ( int i = 0; i < creationPointsQ; i++ ) {
                 TraceLog( LOG_INFO, "%.2f, %.2f", creationPoints[i].x, creationPoints[i].y );
             }
@@ -135,12 +650,89 @@ void handleChainObjectCreation( GameWorld *gw ) {
         }
     }
 
-    if ( IsKeyPressed( KEY_ESCAPE ) ) {
+    if ( input->cancelChain ) {
         creationPointsQ = 0;
     }
 
 }
 
+void handleDynamicObstacleCreation( GameWorld *gw, const GameInput *input ) {
+
+    if ( input->spawnDynamicObstacle ) {
+        if ( gw->obstaclesQuantity < MAX_OBSTACLES ) {
+            createDynamicObstacle( input->mousePosition.x, input->mousePosition.y, 20, 20, BROWN, gw );
+        }
+    }
+
+}
+
+/**
+ * @brief Requests a line of sight check from the player to the mouse
+ * cursor, used by the debug overlay.
+ */
+void requestLineOfSight( GameWorld *gw, const GameInput *input ) {
+
+    gw->lineOfSightQuery = -1;
+
+    if ( gw->showDebugInfo ) {
+        b2Vec2 origin = b2Body_GetPosition( gw->player.bodyId );
+        gw->lineOfSightTarget = (b2Vec2){ input->mousePosition.x, input->mousePosition.y };
+        gw->lineOfSightQuery = requestRayQuery( 
+            &gw->queryService, origin, b2Sub( gw->lineOfSightTarget, origin ), b2DefaultQueryFilter() );
+    }
+
+}
+
+void drawLineOfSight( RenderSnapshot *rs ) {
+
+    if ( !rs->lineOfSightValid ) {
+        return;
+    }
+
+    b2Vec2 origin = rs->lineOfSightOrigin;
+    b2Vec2 end = rs->lineOfSightEnd;
+
+    if ( rs->lineOfSightHit ) {
+        DrawLine( origin.x, origin.y, end.x, end.y, RED );
+        DrawCircle( end.x, end.y, 3, RED );
+    } else {
+        DrawLine( origin.x, origin.y, end.x, end.y, GREEN );
+    }
+
+}
+
+/**
+ * @brief Copies the transforms of the bodies that moved in the last step
+ * to their entities, so drawing doesn't need to query the Box2D world.
+ * Sleeping and static bodies don't generate move events.
+ */
+void syncRenderTransforms( GameWorld *gw ) {
+
+    b2BodyEvents events = b2World_GetBodyEvents( gw->worldId );
+
+    for ( int i = 0; i < events.moveCount; i++ ) {
+
+        const b2BodyMoveEvent *event = &events.moveEvents[i];
+        EntityType *type = (EntityType*) event->userData;
+
+        if ( *type == ENTITY_TYPE_PLAYER ) {
+            Player *p = (Player*) type;
+            p->position = event->transform.p;
+            p->rotation = event->transform.q;
+            p->changedTick = gw->tick;
+        } else if ( *type == ENTITY_TYPE_OBSTACLE ) {
+            Obstacle *o = (Obstacle*) type;
+            o->position = event->transform.p;
+            o->rotation = event->transform.q;
+            o->changedTick = gw->tick;
+        }
+
+    }
+
+    gw->refreshedTransforms = events.moveCount;
+
+}
+
 void createDummyObstcales( GameWorld *gw ) {
 
     b2Vec2 pos[MAX_CHAIN_OBSTACLE_POINTS];
@@ -150,14 +742,14 @@ void createDummyObstcales( GameWorld *gw ) {
     pos[2] = (b2Vec2) { 700, 350 };
     pos[3] = (b2Vec2) { 400, 350 };
     pos[4] = (b2Vec2) { 500, 300 };
-    createChainObstacle( pos, 5, ORANGE, false, gw );
+    createChainObstacle( pos, 5, ORANGE, false, SHAPE_FLAG_NONE, gw );
 
     pos[0] = (b2Vec2) { 100, 350 };
     pos[1] = (b2Vec2) { 99, 350 };
     pos[2] = (b2Vec2) { 20, 350 };
     pos[3] = (b2Vec2) { 20, 300 };
     pos[4] = (b2Vec2) { 50, 300 };
-    createChainObstacle( pos, 5, ORANGE, false, gw );
+    createChainObstacle( pos, 5, ORANGE, false, SHAPE_FLAG_NONE, gw );
 
     pos[0] = (b2Vec2) { 550, 80 };
     pos[1] = (b2Vec2) { 550, 80 };
@@ -170,7 +762,16 @@ void createDummyObstcales( GameWorld *gw ) {
     pos[8] = (b2Vec2) { 510, 210 };
     pos[9] = (b2Vec2) { 450, 160 };
     pos[10] = (b2Vec2) { 530, 160 };
-    createChainObstacle( pos, 11, ORANGE, true, gw );
+    createChainObstacle( pos, 11, ORANGE, true, SHAPE_FLAG_NONE, gw );
+
+    // one way platforms, a box and a slanted slab
+    createObstacle( 250, 340, 120, 8, DARKGREEN, SHAPE_FLAG_ONE_WAY, gw );
+
+    pos[0] = (b2Vec2) { 110, 270 };
+    pos[1] = (b2Vec2) { 230, 250 };
+    pos[2] = (b2Vec2) { 230, 258 };
+    pos[3] = (b2Vec2) { 110, 278 };
+    createChainObstacle( pos, 4, DARKGREEN, false, SHAPE_FLAG_ONE_WAY, gw );
         
 }
 
@@ -180,33 +781,94 @@ void handleContactEvents( GameWorld *gw ) {
     
     for ( int i = 0; i < events.beginCount; i++ ) {
         const b2ContactBeginTouchEvent *event = &events.beginEvents[i];
-        handleContacBetweenShapes( event->shapeIdA, event->shapeIdB, GREEN );
+        handleContacBetweenShapes( gw, event->shapeIdA, event->shapeIdB, GREEN );
+
+        // dust where the shapes started touching, going away from the floor
+        if ( event->manifold.pointCount > 0 ) {
+            float speed = -event->manifold.points[0].normalVelocity;
+            if ( speed > PARTICLE_CONTACT_MIN_SPEED ) {
+                b2Vec2 normal = event->manifold.normal;
+                addParticleEmitter( 
+                    gw, event->manifold.points[0].point, normal.y > 0.0f ? b2Neg( normal ) : normal, 
+                    speed * 0.5f, (int) fminf( speed / PARTICLE_SPEED_PER_PARTICLE, PARTICLE_MAX_BURST ), LIGHTGRAY 
+                );
+            }
+        }
+    }
+
+    // sparks where dynamic shapes hit something fast
+    for ( int i = 0; i < events.hitCount; i++ ) {
+        const b2ContactHitEvent *event = &events.hitEvents[i];
+        addParticleEmitter( 
+            gw, event->point, event->normal.y > 0.0f ? b2Neg( event->normal ) : event->normal, 
+            event->approachSpeed * 0.6f, (int) fminf( 2.0f * event->approachSpeed / PARTICLE_SPEED_PER_PARTICLE, PARTICLE_MAX_BURST ), ORANGE 
+        );
+        addImpact( gw, event );
     }
 
     for ( int i = 0; i < events.endCount; i++ ) {
         const b2ContactEndTouchEvent *event = &events.endEvents[i];
-        handleContacBetweenShapes( event->shapeIdA, event->shapeIdB, ORANGE );
+        handleContacBetweenShapes( gw, event->shapeIdA, event->shapeIdB, ORANGE );
+    }
+
+}
+
+/**
+ * @brief Records a burst of particles for the renderer.
+ */
+void addParticleEmitter( GameWorld *gw, b2Vec2 position, b2Vec2 direction, float speed, int quantity, Color color ) {
+
+    if ( quantity <= 0 ) {
+        return;
     }
 
+    gw->particleEmitters[gw->particleEmitterTotal % PARTICLE_EMITTER_HISTORY] = (ParticleEmitter){
+        position, direction, speed, quantity, color
+    };
+    gw->particleEmitterTotal++;
+
 }
 
-void handleContacBetweenShapes( b2ShapeId sIdA, b2ShapeId sIdB, Color color ) {
+/**
+ * @brief Records a hit for the impact audio.
+ */
+void addImpact( GameWorld *gw, const b2ContactHitEvent *event ) {
+
+    // the hit shapes are alive, only the end events report destroyed ones
+    uint32_t a = (uint32_t) b2Shape_GetBody( event->shapeIdA ).index1;
+    uint32_t b = (uint32_t) b2Shape_GetBody( event->shapeIdB ).index1;
+
+    gw->impacts[gw->impactTotal % IMPACT_HISTORY] = (ImpactEvent){
+        event->point, event->approachSpeed,
+        a < b ? ( (uint64_t) a << 32 ) | b : ( (uint64_t) b << 32 ) | a
+    };
+    gw->impactTotal++;
+
+}
+
+void handleContacBetweenShapes( GameWorld *gw, b2ShapeId sIdA, b2ShapeId sIdB, Color color ) {
+
+    // end events are also reported for shapes destroyed by carving
+    if ( !b2Shape_IsValid( sIdA ) || !b2Shape_IsValid( sIdB ) ) {
+        return;
+    }
 
     b2BodyId bIdA = b2Shape_GetBody( sIdA );
     b2BodyId bIdB = b2Shape_GetBody( sIdB );
 
-    char *userDataA = (char*) b2Body_GetUserData( bIdA );
-    char *userDataB = (char*) b2Body_GetUserData( bIdB );
+    EntityType *typeA = (EntityType*) b2Body_GetUserData( bIdA );
+    EntityType *typeB = (EntityType*) b2Body_GetUserData( bIdB );
 
     ChainObstacle *co = NULL;
-    if ( userDataA[0] == 'c' ) {
+    if ( *typeA == ENTITY_TYPE_CHAIN_OBSTACLE ) {
         co = (ChainObstacle*) b2Shape_GetUserData( sIdA );
-    } else if ( userDataB[0] == 'c' ) {
+    } else if ( *typeB == ENTITY_TYPE_CHAIN_OBSTACLE ) {
         co = (ChainObstacle*) b2Shape_GetUserData( sIdB );
     }
 
     if ( co != NULL ) {
         co->color = color;
+        co->changedTick = gw->tick;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+/**
+ * @file GeometryBuffer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Streaming geometry buffer implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "GeometryBuffer.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+#define RAYMATH_STATIC_INLINE
+#include "raylib/raymath.h"
+
+static const char *vertexShaderCode =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in vec4 vertexColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp * vec4( vertexPosition, 0.0, 1.0 );\n"
+    "}\n";
+
+static const char *fragmentShaderCode =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+/**
+ * @brief Creates a dinamically allocated GeometryBuffer struct instance
+ * holding up to capacity vertices between flushes. Needs an OpenGL
+ * context.
+ */
+GeometryBuffer* createGeometryBuffer( int capacity ) {
+
+    GeometryBuffer *gb = (GeometryBuffer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( GeometryBuffer ) );
+
+    gb->capacity = capacity;
+    gb->vertices = (GeometryVertex*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( GeometryVertex ) * capacity );
+    gb->vertexQuantity = 0;
+    gb->ringIndex = 0;
+    gb->frameVertices = 0;
+    gb->frameFlushes = 0;
+    gb->peakFrameVertices = 0;
+
+    gb->shaderId = rlLoadShaderCode( vertexShaderCode, fragmentShaderCode );
+    gb->ready = gb->shaderId != 0 && gb->shaderId != rlGetShaderIdDefault();
+
+    if ( !gb->ready ) {
+        TraceLog( LOG_WARNING, "GEOMETRY: shader not available, using immediate mode" );
+        return gb;
+    }
+
+    gb->mvpLoc = rlGetLocationUniform( gb->shaderId, "mvp" );
+    int positionLoc = rlGetLocationAttrib( gb->shaderId, "vertexPosition" );
+    int colorLoc = rlGetLocationAttrib( gb->shaderId, "vertexColor" );
+
+    for ( int i = 0; i < GEOMETRY_BUFFER_RING_SIZE; i++ ) {
+        gb->vaoIds[i] = rlLoadVertexArray();
+        rlEnableVertexArray( gb->vaoIds[i] );
+        gb->vboIds[i] = rlLoadVertexBuffer( NULL, sizeof( GeometryVertex ) * capacity, true );
+        rlSetVertexAttribute( positionLoc, 2, RL_FLOAT, false, sizeof( GeometryVertex ), offsetof( GeometryVertex, x ) );
+        rlEnableVertexAttribute( positionLoc );
+        rlSetVertexAttribute( colorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof( GeometryVertex ), offsetof( GeometryVertex, color ) );
+        rlEnableVertexAttribute( colorLoc );
+        rlDisableVertexArray();
+    }
+
+    return gb;
+
+}
+
+/**
+ * @brief Destroys a GeometryBuffer object and its GPU resources.
+ */
+void destroyGeometryBuffer( GeometryBuffer *gb ) {
+
+    if ( gb->ready ) {
+        for ( int i = 0; i < GEOMETRY_BUFFER_RING_SIZE; i++ ) {
+            rlUnloadVertexBuffer( gb->vboIds[i] );
+            rlUnloadVertexArray( gb->vaoIds[i] );
+        }
+        rlUnloadShaderProgram( gb->shaderId );
+    }
+
+    freeMemory( gb->vertices );
+    freeMemory( gb );
+
+}
+
+/**
+ * @brief Resets the frame counters.
+ */
+void beginGeometryFrame( GeometryBuffer *gb ) {
+    gb->vertexQuantity = 0;
+    gb->frameVertices = 0;
+    gb->frameFlushes = 0;
+}
+
+/**
+ * @brief Reserves count triangle vertices to be written by the caller,
+ * flushing first if they don't fit. Returns NULL if count is larger than
+ * the capacity or the buffer is not available.
+ */
+GeometryVertex* reserveGeometryVertices( GeometryBuffer *gb, int count ) {
+
+    if ( !gb->ready || count > gb->capacity ) {
+        return NULL;
+    }
+
+    if ( gb->vertexQuantity + count > gb->capacity ) {
+        flushGeometryBuffer( gb );
+    }
+
+    GeometryVertex *v = &gb->vertices[gb->vertexQuantity];
+    gb->vertexQuantity += count;
+    gb->frameVertices += count;
+
+    if ( gb->frameVertices > gb->peakFrameVertices ) {
+        gb->peakFrameVertices = gb->frameVertices;
+    }
+
+    return v;
+
+}
+
+/**
+ * @brief Draws all the written vertices in one call.
+ */
+void flushGeometryBuffer( GeometryBuffer *gb ) {
+
+    if ( !gb->ready || gb->vertexQuantity == 0 ) {
+        return;
+    }
+
+    // keeps the order with what was drawn through raylib before
+    rlDrawRenderBatchActive();
+
+    int ring = gb->ringIndex;
+    gb->ringIndex = ( gb->ringIndex + 1 ) % GEOMETRY_BUFFER_RING_SIZE;
+
+    rlUpdateVertexBuffer( gb->vboIds[ring], gb->vertices, sizeof( GeometryVertex ) * gb->vertexQuantity, 0 );
+
+    rlEnableShader( gb->shaderId );
+    rlSetUniformMatrix( gb->mvpLoc, MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() ) );
+
+    rlEnableVertexArray( gb->vaoIds[ring] );
+    rlDrawVertexArray( 0, gb->vertexQuantity );
+    rlDisableVertexArray();
+
+    rlDisableShader();
+
+    gb->vertexQuantity = 0;
+    gb->frameFlushes++;
+
+}
@@ -0,0 +1,220 @@
+/**
+ * @file GpuTimer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief GPU timer implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#if !defined( _WIN32 )
+    // RTLD_DEFAULT
+    #define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "GpuTimer.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+// timer queries are OpenGL 3.3 functions, not exposed by rlgl, so they
+// are loaded from the OpenGL library the game already links (opengl32 or
+// libGL); where it can't be done the timer is not ready
+#if defined( _WIN32 ) && !defined( _WIN64 )
+    #define GPU_TIMER_GL_API __stdcall
+#else
+    #define GPU_TIMER_GL_API
+#endif
+
+#if defined( _WIN32 )
+    #define GPU_TIMER_LOADER_AVAILABLE 1
+#elif defined( __unix__ ) || defined( __APPLE__ )
+    #include <dlfcn.h>
+    #define GPU_TIMER_LOADER_AVAILABLE 1
+#else
+    #define GPU_TIMER_LOADER_AVAILABLE 0
+#endif
+
+#define GPU_TIMER_GL_TIME_ELAPSED 0x88BF
+#define GPU_TIMER_GL_QUERY_RESULT 0x8866
+#define GPU_TIMER_GL_QUERY_RESULT_AVAILABLE 0x8867
+
+typedef void ( *GpuTimerProc )( void );
+
+#if defined( _WIN32 )
+// windows.h can't be included with raylib.h
+__declspec( dllimport ) GpuTimerProc __stdcall wglGetProcAddress( const char *name );
+#endif
+
+static GpuTimerProc getProcAddress( const char *name ) {
+
+#if defined( _WIN32 )
+    GpuTimerProc proc = wglGetProcAddress( name );
+    // some drivers return small values instead of NULL on failure
+    intptr_t value = (intptr_t) proc;
+    if ( value >= -1 && value <= 3 ) {
+        return NULL;
+    }
+    return proc;
+#elif GPU_TIMER_LOADER_AVAILABLE
+    // the functions are exported by libGL (or the OpenGL framework), ISO
+    // C has no cast from an object pointer to a function pointer
+    void *address = dlsym( RTLD_DEFAULT, name );
+    GpuTimerProc proc;
+    memcpy( &proc, &address, sizeof( proc ) );
+    return proc;
+#else
+    return NULL;
+#endif
+
+}
+
+typedef void ( GPU_TIMER_GL_API *GenQueriesProc )( int n, unsigned int *ids );
+typedef void ( GPU_TIMER_GL_API *DeleteQueriesProc )( int n, const unsigned int *ids );
+typedef void ( GPU_TIMER_GL_API *BeginQueryProc )( unsigned int target, unsigned int id );
+typedef void ( GPU_TIMER_GL_API *EndQueryProc )( unsigned int target );
+typedef void ( GPU_TIMER_GL_API *GetQueryObjectivProc )( unsigned int id, unsigned int pname, int *params );
+typedef void ( GPU_TIMER_GL_API *GetQueryObjectui64vProc )( unsigned int id, unsigned int pname, uint64_t *params );
+
+static GenQueriesProc genQueries = NULL;
+static DeleteQueriesProc deleteQueries = NULL;
+static BeginQueryProc beginQuery = NULL;
+static EndQueryProc endQuery = NULL;
+static GetQueryObjectivProc getQueryObjectiv = NULL;
+static GetQueryObjectui64vProc getQueryObjectui64v = NULL;
+
+static bool loadQueryFunctions( void ) {
+
+    if ( !GPU_TIMER_LOADER_AVAILABLE ) {
+        return false;
+    }
+
+    if ( genQueries == NULL ) {
+        genQueries = (GenQueriesProc) getProcAddress( "glGenQueries" );
+        deleteQueries = (DeleteQueriesProc) getProcAddress( "glDeleteQueries" );
+        beginQuery = (BeginQueryProc) getProcAddress( "glBeginQuery" );
+        endQuery = (EndQueryProc) getProcAddress( "glEndQuery" );
+        getQueryObjectiv = (GetQueryObjectivProc) getProcAddress( "glGetQueryObjectiv" );
+        getQueryObjectui64v = (GetQueryObjectui64vProc) getProcAddress( "glGetQueryObjectui64v" );
+    }
+
+    return genQueries != NULL && deleteQueries != NULL && beginQuery != NULL &&
+           endQuery != NULL && getQueryObjectiv != NULL && getQueryObjectui64v != NULL;
+
+}
+
+static void collectResults( GpuTimer *gt ) {
+
+    for ( int i = 0; i < GPU_TIMER_QUERIES; i++ ) {
+
+        if ( !gt->pending[i] ) {
+            continue;
+        }
+
+        int available = 0;
+        getQueryObjectiv( gt->queries[i], GPU_TIMER_GL_QUERY_RESULT_AVAILABLE, &available );
+
+        if ( available ) {
+            uint64_t nanoseconds = 0;
+            getQueryObjectui64v( gt->queries[i], GPU_TIMER_GL_QUERY_RESULT, &nanoseconds );
+            gt->lastTime = nanoseconds / 1000000.0;
+            gt->samples++;
+            gt->averageTime += ( gt->lastTime - gt->averageTime ) / gt->samples;
+            gt->pending[i] = false;
+        }
+
+    }
+
+}
+
+/**
+ * @brief Creates a dinamically allocated GpuTimer struct instance. Needs
+ * an OpenGL 3.3 context, otherwise the timer stays not ready and its
+ * functions do nothing.
+ */
+GpuTimer* createGpuTimer( void ) {
+
+    GpuTimer *gt = (GpuTimer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( GpuTimer ) );
+
+    gt->current = 0;
+    gt->running = false;
+    gt->lastTime = 0.0;
+    gt->averageTime = 0.0;
+    gt->samples = 0;
+    gt->ready = ( rlGetVersion() == RL_OPENGL_33 || rlGetVersion() == RL_OPENGL_43 ) && loadQueryFunctions();
+
+    for ( int i = 0; i < GPU_TIMER_QUERIES; i++ ) {
+        gt->queries[i] = 0;
+        gt->pending[i] = false;
+    }
+
+    if ( gt->ready ) {
+        genQueries( GPU_TIMER_QUERIES, gt->queries );
+    } else {
+        TraceLog( LOG_WARNING, "GPU TIMER: timer queries not available" );
+    }
+
+    return gt;
+
+}
+
+/**
+ * @brief Destroys a GpuTimer object and its queries.
+ */
+void destroyGpuTimer( GpuTimer *gt ) {
+    if ( gt->ready ) {
+        deleteQueries( GPU_TIMER_QUERIES, gt->queries );
+    }
+    freeMemory( gt );
+}
+
+/**
+ * @brief Starts measuring the GPU commands of a frame.
+ */
+void beginGpuTimer( GpuTimer *gt ) {
+
+    if ( !gt->ready ) {
+        return;
+    }
+
+    collectResults( gt );
+
+    // all queries in flight, skips this frame instead of waiting
+    if ( gt->pending[gt->current] ) {
+        return;
+    }
+
+    rlDrawRenderBatchActive();
+    beginQuery( GPU_TIMER_GL_TIME_ELAPSED, gt->queries[gt->current] );
+    gt->running = true;
+
+}
+
+/**
+ * @brief Stops measuring and collects the results that are available.
+ */
+void endGpuTimer( GpuTimer *gt ) {
+
+    if ( !gt->running ) {
+        return;
+    }
+
+    rlDrawRenderBatchActive();
+    endQuery( GPU_TIMER_GL_TIME_ELAPSED );
+    gt->pending[gt->current] = true;
+    gt->current = ( gt->current + 1 ) % GPU_TIMER_QUERIES;
+    gt->running = false;
+
+}
+
+/**
+ * @brief Restarts the average, e.g. when the render settings change.
+ */
+void resetGpuTimer( GpuTimer *gt ) {
+    gt->averageTime = 0.0;
+    gt->samples = 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file ImpactAudio.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Impact audio implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "ImpactAudio.h"
+#include "Memory.h"
+#include "Random.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+
+#define IMPACT_SAMPLE_RATE 22050
+
+/*
+ * A thump with a noise burst on top, both decaying fast.
+ */
+static Sound createImpactSound( float duration ) {
+
+    int frameCount = (int) ( duration * IMPACT_SAMPLE_RATE );
+    short *samples = (short*) allocMemory( MEMORY_SUBSYSTEM_WINDOW, sizeof( short ) * frameCount );
+    uint32_t seed = 0x2545f491u;
+
+    for ( int i = 0; i < frameCount; i++ ) {
+
+        float t = (float) i / IMPACT_SAMPLE_RATE;
+
+        float noise = 2.0f * nextRandomFloat( &seed ) - 1.0f;
+
+        float thump = sinf( 2.0f * PI * ( 70.0f + 60.0f * expf( -t * 40.0f ) ) * t ) * expf( -t * 14.0f );
+        float value = 0.7f * thump + 0.35f * noise * expf( -t * 45.0f );
+
+        samples[i] = (short) ( fmaxf( -1.0f, fminf( 1.0f, value ) ) * 32000.0f );
+
+    }
+
+    Wave wave = {
+        .frameCount = (unsigned int) frameCount,
+        .sampleRate = IMPACT_SAMPLE_RATE,
+        .sampleSize = 16,
+        .channels = 1,
+        .data = samples
+    };
+
+    // the samples are copied into the audio buffer
+    Sound sound = LoadSoundFromWave( wave );
+    freeMemory( samples );
+
+    return sound;
+
+}
+
+static bool isVoicePlaying( const ImpactAudio *ia, const ImpactVoice *v, double now ) {
+    if ( ia->ready ) {
+        return IsSoundPlaying( v->sound );
+    }
+    return now - v->startTime < ia->duration;
+}
+
+// a playing hit gets quieter, so it is easier to steal from
+static float getVoicePriority( const ImpactAudio *ia, const ImpactVoice *v, double now ) {
+    return v->speed * fmaxf( 0.0f, 1.0f - (float) ( now - v->startTime ) / ia->duration );
+}
+
+static bool isRecentPair( const ImpactAudio *ia, uint64_t key, double now ) {
+
+    for ( int i = 0; i < IMPACT_AUDIO_PAIR_HISTORY; i++ ) {
+        if ( ia->pairs[i].key == key && now - ia->pairs[i].time < ia->dedupeWindow ) {
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+static void rememberPair( ImpactAudio *ia, uint64_t key, double now ) {
+    ia->pairs[ia->pairCursor] = (ImpactPair){ key, now };
+    ia->pairCursor = ( ia->pairCursor + 1 ) % IMPACT_AUDIO_PAIR_HISTORY;
+}
+
+static void startImpactVoice( ImpactAudio *ia, const ImpactEvent *e, double now ) {
+
+    ImpactVoice *voice = NULL;
+    ImpactVoice *quietest = NULL;
+    float quietestPriority = 0.0f;
+
+    for ( int i = 0; i < IMPACT_AUDIO_VOICES; i++ ) {
+
+        ImpactVoice *v = &ia->voices[i];
+
+        if ( !isVoicePlaying( ia, v, now ) ) {
+            voice = v;
+            break;
+        }
+
+        float priority = getVoicePriority( ia, v, now );
+        if ( quietest == NULL || priority < quietestPriority ) {
+            quietest = v;
+            quietestPriority = priority;
+        }
+
+    }
+
+    if ( voice == NULL ) {
+        if ( quietestPriority >= e->speed ) {
+            ia->limited++;
+            return;
+        }
+        voice = quietest;
+        ia->stolen++;
+        if ( ia->ready ) {
+            StopSound( voice->sound );
+        }
+    }
+
+    voice->speed = e->speed;
+    voice->startTime = now;
+    ia->started++;
+
+    // only heard hits silence the pair, a dropped one didn't play
+    rememberPair( ia, e->pairKey, now );
+
+    if ( ia->ready ) {
+        float volume = fmaxf( 0.05f, fminf( 1.0f, e->speed / ia->fullVolumeSpeed ) );
+        SetSoundVolume( voice->sound, volume );
+        // heavier hits sound lower
+        SetSoundPitch( voice->sound, 1.2f - 0.4f * volume );
+        SetSoundPan( voice->sound, fmaxf( 0.0f, fminf( 1.0f, e->position.x / ia->width ) ) );
+        PlaySound( voice->sound );
+    }
+
+}
+
+/**
+ * @brief Creates a dinamically allocated ImpactAudio struct instance with
+ * a procedural impact sound. Without an audio device the hits are only
+ * counted. width is the size of the world, for the stereo panning.
+ */
+ImpactAudio* createImpactAudio( float width ) {
+
+    ImpactAudio *ia = (ImpactAudio*) allocMemory( MEMORY_SUBSYSTEM_WINDOW, sizeof( ImpactAudio ) );
+
+    ia->dedupeWindow = 0.15f;
+    ia->minSpeed = 160.0f;
+    ia->fullVolumeSpeed = 1500.0f;
+    ia->duration = 0.35f;
+    ia->width = width > 0.0f ? width : 1.0f;
+    ia->impactTotal = 0;
+    ia->pairCursor = 0;
+
+    for ( int i = 0; i < IMPACT_AUDIO_PAIR_HISTORY; i++ ) {
+        ia->pairs[i] = (ImpactPair){ 0, -1.0e9 };
+    }
+
+    ia->received = 0;
+    ia->deduplicated = 0;
+    ia->limited = 0;
+    ia->started = 0;
+    ia->stolen = 0;
+    ia->playing = 0;
+
+    ia->ready = IsAudioDeviceReady();
+    if ( ia->ready ) {
+        ia->impactSound = createImpactSound( ia->duration );
+        ia->ready = IsSoundValid( ia->impactSound );
+    }
+
+    if ( !ia->ready ) {
+        TraceLog( LOG_WARNING, "AUDIO: no audio device, impacts are only counted" );
+    }
+
+    // the voices share the samples, so the pool costs no audio memory
+    for ( int i = 0; i < IMPACT_AUDIO_VOICES; i++ ) {
+        ia->voices[i].sound = ia->ready ? LoadSoundAlias( ia->impactSound ) : (Sound){ 0 };
+        ia->voices[i].speed = 0.0f;
+        ia->voices[i].startTime = -1.0e9;
+    }
+
+    return ia;
+
+}
+
+/**
+ * @brief Destroys an ImpactAudio object and its sounds.
+ */
+void destroyImpactAudio( ImpactAudio *ia ) {
+
+    if ( ia->ready ) {
+        for ( int i = 0; i < IMPACT_AUDIO_VOICES; i++ ) {
+            UnloadSoundAlias( ia->voices[i].sound );
+        }
+        UnloadSound( ia->impactSound );
+    }
+
+    freeMemory( ia );
+
+}
+
+/**
+ * @brief Plays the hits of the snapshot that weren't heard yet.
+ */
+void updateImpactAudio( ImpactAudio *ia, const RenderSnapshot *rs ) {
+
+    double now = GetTime();
+
+    ia->received = 0;
+    ia->deduplicated = 0;
+    ia->limited = 0;
+    ia->started = 0;
+    ia->stolen = 0;
+
+    // a new world starts counting again
+    if ( rs->impactTotal < ia->impactTotal ) {
+        ia->impactTotal = rs->impactTotal;
+    }
+
+    int first = ia->impactTotal;
+    if ( rs->impactTotal - first > IMPACT_HISTORY ) {
+        first = rs->impactTotal - IMPACT_HISTORY;
+    }
+
+    // fastest hits of the frame, from the fastest
+    const ImpactEvent *selected[IMPACT_AUDIO_MAX_STARTS];
+    int selectedQuantity = 0;
+
+    for ( int i = first; i < rs->impactTotal; i++ ) {
+
+        const ImpactEvent *e = &rs->impacts[i % IMPACT_HISTORY];
+        ia->received++;
+
+        if ( e->speed < ia->minSpeed ) {
+            ia->limited++;
+            continue;
+        }
+
+        if ( isRecentPair( ia, e->pairKey, now ) ) {
+            ia->deduplicated++;
+            continue;
+        }
+
+        // the pairs are only remembered when a voice starts, so the
+        // repeated hits of a pair in this frame are merged here
+        int same = 0;
+        while ( same < selectedQuantity && selected[same]->pairKey != e->pairKey ) {
+            same++;
+        }
+        if ( same < selectedQuantity ) {
+            ia->deduplicated++;
+            if ( selected[same]->speed >= e->speed ) {
+                continue;
+            }
+            for ( int j = same; j < selectedQuantity - 1; j++ ) {
+                selected[j] = selected[j + 1];
+            }
+            selectedQuantity--;
+        }
+
+        if ( selectedQuantity == IMPACT_AUDIO_MAX_STARTS ) {
+            if ( selected[selectedQuantity - 1]->speed >= e->speed ) {
+                ia->limited++;
+                continue;
+            }
+            selectedQuantity--;
+            ia->limited++;
+        }
+
+        int j = selectedQuantity++;
+        while ( j > 0 && selected[j - 1]->speed < e->speed ) {
+            selected[j] = selected[j - 1];
+            j--;
+        }
+        selected[j] = e;
+
+    }
+
+    ia->impactTotal = rs->impactTotal;
+
+    for ( int i = 0; i < selectedQuantity; i++ ) {
+        startImpactVoice( ia, selected[i], now );
+    }
+
+    ia->playing = 0;
+    for ( int i = 0; i < IMPACT_AUDIO_VOICES; i++ ) {
+        if ( isVoicePlaying( ia, &ia->voices[i], now ) ) {
+            ia->playing++;
+        }
+    }
+
+}
+
+/**
+ * @brief Draws the impact audio counters.
+ */
+void drawImpactAudioStats( const ImpactAudio *ia, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "impacts%s: %d hits, %d deduplicated, %d limited, %d started (%d stolen), %d/%d voices playing",
+            ia->ready ? "" : " (no audio)", ia->received, ia->deduplicated, ia->limited,
+            ia->started, ia->stolen, ia->playing, IMPACT_AUDIO_VOICES
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
@@ -0,0 +1,203 @@
+/**
+ * @file InstancedRenderer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Instanced box renderer implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "InstancedRenderer.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+#define RAYMATH_STATIC_INLINE
+#include "raylib/raymath.h"
+
+static const char *vertexShaderCode =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in vec4 instanceRect;\n"
+    "in vec2 instanceRotation;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    vec2 local = vertexPosition * instanceRect.zw;\n"
+    "    vec2 rotated = vec2( local.x * instanceRotation.x - local.y * instanceRotation.y,\n"
+    "                         local.x * instanceRotation.y + local.y * instanceRotation.x );\n"
+    "    fragColor = instanceColor;\n"
+    "    gl_Position = mvp * vec4( instanceRect.xy + rotated, 0.0, 1.0 );\n"
+    "}\n";
+
+static const char *fragmentShaderCode =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+/**
+ * @brief Unit quad centered at the origin, two triangles wound counter
+ * clockwise on the screen like DrawRectangle, since raylib culls the back
+ * faces.
+ */
+const float unitQuadVertices[UNIT_QUAD_VERTEX_QUANTITY*2] = {
+    -0.5f, -0.5f,  -0.5f,  0.5f,   0.5f,  0.5f,
+    -0.5f, -0.5f,   0.5f,  0.5f,   0.5f, -0.5f
+};
+
+/**
+ * @brief Creates a dinamically allocated InstancedRenderer struct instance
+ * holding up to capacity boxes per draw call. Needs an OpenGL context.
+ */
+InstancedRenderer* createInstancedRenderer( int capacity ) {
+
+    InstancedRenderer *ir = (InstancedRenderer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( InstancedRenderer ) );
+
+    ir->capacity = capacity;
+    ir->instances = (BoxInstance*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( BoxInstance ) * capacity );
+    ir->instanceQuantity = 0;
+    ir->drawnInstances = 0;
+    ir->culledInstances = 0;
+    ir->drawCalls = 0;
+
+    ir->shaderId = rlLoadShaderCode( vertexShaderCode, fragmentShaderCode );
+    ir->ready = ir->shaderId != 0 && ir->shaderId != rlGetShaderIdDefault();
+
+    if ( !ir->ready ) {
+        TraceLog( LOG_WARNING, "INSTANCING: shader not available, using immediate mode" );
+        ir->vaoId = 0;
+        ir->quadVboId = 0;
+        ir->instanceVboId = 0;
+        return ir;
+    }
+
+    ir->mvpLoc = rlGetLocationUniform( ir->shaderId, "mvp" );
+    int positionLoc = rlGetLocationAttrib( ir->shaderId, "vertexPosition" );
+    int rectLoc = rlGetLocationAttrib( ir->shaderId, "instanceRect" );
+    int rotationLoc = rlGetLocationAttrib( ir->shaderId, "instanceRotation" );
+    int colorLoc = rlGetLocationAttrib( ir->shaderId, "instanceColor" );
+
+    ir->vaoId = rlLoadVertexArray();
+    rlEnableVertexArray( ir->vaoId );
+
+    ir->quadVboId = rlLoadVertexBuffer( unitQuadVertices, sizeof( unitQuadVertices ), false );
+    rlSetVertexAttribute( positionLoc, 2, RL_FLOAT, false, 0, 0 );
+    rlEnableVertexAttribute( positionLoc );
+
+    ir->instanceVboId = rlLoadVertexBuffer( NULL, sizeof( BoxInstance ) * capacity, true );
+    rlSetVertexAttribute( rectLoc, 4, RL_FLOAT, false, sizeof( BoxInstance ), offsetof( BoxInstance, x ) );
+    rlEnableVertexAttribute( rectLoc );
+    rlSetVertexAttributeDivisor( rectLoc, 1 );
+    rlSetVertexAttribute( rotationLoc, 2, RL_FLOAT, false, sizeof( BoxInstance ), offsetof( BoxInstance, cos ) );
+    rlEnableVertexAttribute( rotationLoc );
+    rlSetVertexAttributeDivisor( rotationLoc, 1 );
+    rlSetVertexAttribute( colorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof( BoxInstance ), offsetof( BoxInstance, color ) );
+    rlEnableVertexAttribute( colorLoc );
+    rlSetVertexAttributeDivisor( colorLoc, 1 );
+
+    rlDisableVertexArray();
+
+    return ir;
+
+}
+
+/**
+ * @brief Destroys an InstancedRenderer object and its GPU resources.
+ */
+void destroyInstancedRenderer( InstancedRenderer *ir ) {
+
+    if ( ir->ready ) {
+        rlUnloadVertexBuffer( ir->instanceVboId );
+        rlUnloadVertexBuffer( ir->quadVboId );
+        rlUnloadVertexArray( ir->vaoId );
+        rlUnloadShaderProgram( ir->shaderId );
+    }
+
+    freeMemory( ir->instances );
+    freeMemory( ir );
+
+}
+
+/**
+ * @brief Resets the frame counters.
+ */
+void beginInstancedFrame( InstancedRenderer *ir ) {
+    ir->instanceQuantity = 0;
+    ir->drawnInstances = 0;
+    ir->culledInstances = 0;
+    ir->drawCalls = 0;
+}
+
+/**
+ * @brief Adds a box centered at position. Boxes outside the screen are
+ * culled. The batch is flushed when full.
+ */
+void addBoxInstance( InstancedRenderer *ir, b2Vec2 position, b2Rot rotation, Vector2 dim, Color color ) {
+
+    float radius = 0.5f * sqrtf( dim.x * dim.x + dim.y * dim.y );
+    if ( position.x + radius < 0 || position.x - radius > GetScreenWidth() ||
+         position.y + radius < 0 || position.y - radius > GetScreenHeight() ) {
+        ir->culledInstances++;
+        return;
+    }
+
+    if ( !ir->ready ) {
+        DrawRectanglePro( 
+            (Rectangle){ position.x, position.y, dim.x, dim.y },
+            (Vector2) { dim.x / 2, dim.y / 2 }, 
+            RAD2DEG * b2Rot_GetAngle( rotation ),
+            color
+        );
+        ir->drawnInstances++;
+        return;
+    }
+
+    if ( ir->instanceQuantity == ir->capacity ) {
+        flushBoxInstances( ir );
+    }
+
+    ir->instances[ir->instanceQuantity++] = (BoxInstance) {
+        position.x, position.y, dim.x, dim.y,
+        rotation.c, rotation.s,
+        { color.r, color.g, color.b, color.a }
+    };
+
+}
+
+/**
+ * @brief Draws the gathered boxes in a single instanced draw call.
+ */
+void flushBoxInstances( InstancedRenderer *ir ) {
+
+    if ( !ir->ready || ir->instanceQuantity == 0 ) {
+        return;
+    }
+
+    // keeps the order with what was drawn through raylib before
+    rlDrawRenderBatchActive();
+
+    Matrix mvp = MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() );
+
+    rlEnableShader( ir->shaderId );
+    rlSetUniformMatrix( ir->mvpLoc, mvp );
+
+    rlUpdateVertexBuffer( ir->instanceVboId, ir->instances, sizeof( BoxInstance ) * ir->instanceQuantity, 0 );
+
+    rlEnableVertexArray( ir->vaoId );
+    rlDrawVertexArrayInstanced( 0, UNIT_QUAD_VERTEX_QUANTITY, ir->instanceQuantity );
+    rlDisableVertexArray();
+
+    rlDisableShader();
+
+    ir->drawnInstances += ir->instanceQuantity;
+    ir->drawCalls++;
+    ir->instanceQuantity = 0;
+
+}
@@ -0,0 +1,107 @@
+/**
+ * @file LabelCache.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Chain vertex label cache implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "LabelCache.h"
+#include "Memory.h"
+#include "ChainObstacle.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+
+static void rebuildLabelCache( LabelCache *lc, RenderSnapshot *rs ) {
+
+    if ( lc->target.id == 0 ||
+         lc->target.texture.width != GetScreenWidth() ||
+         lc->target.texture.height != GetScreenHeight() ) {
+        if ( lc->target.id != 0 ) {
+            UnloadRenderTexture( lc->target );
+        }
+        lc->target = LoadRenderTexture( GetScreenWidth(), GetScreenHeight() );
+    }
+
+    BeginTextureMode( lc->target );
+    ClearBackground( BLANK );
+    for ( int i = 0; i < rs->chainObstacleQuantity; i++ ) {
+        drawChainObstacleLabels( &rs->chainObstacles[i] );
+    }
+    EndTextureMode();
+
+    lc->revision = rs->staticRevision;
+    lc->carvedRegions = rs->carver.regionTotal;
+    lc->valid = true;
+    lc->rebuilds++;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated LabelCache struct instance.
+ * Needs an OpenGL context.
+ */
+LabelCache* createLabelCache( void ) {
+
+    LabelCache *lc = (LabelCache*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( LabelCache ) );
+
+    lc->target = (RenderTexture2D) { 0 };
+    lc->revision = 0;
+    lc->carvedRegions = 0;
+    lc->valid = false;
+    lc->rebuilds = 0;
+
+    return lc;
+
+}
+
+/**
+ * @brief Destroys a LabelCache object and its render texture.
+ */
+void destroyLabelCache( LabelCache *lc ) {
+    if ( lc->target.id != 0 ) {
+        UnloadRenderTexture( lc->target );
+    }
+    freeMemory( lc );
+}
+
+/**
+ * @brief Marks the cache as outdated.
+ */
+void invalidateLabelCache( LabelCache *lc ) {
+    lc->valid = false;
+}
+
+/**
+ * @brief Rebuilds the cache if the static geometry of the snapshot
+ * changed. Must be called between BeginDrawing and EndDrawing, outside
+ * of any other texture mode.
+ */
+void updateLabelCache( LabelCache *lc, RenderSnapshot *rs ) {
+
+    if ( !lc->valid || lc->revision != rs->staticRevision || lc->carvedRegions != rs->carver.regionTotal ||
+         lc->target.texture.width != GetScreenWidth() ||
+         lc->target.texture.height != GetScreenHeight() ) {
+        rebuildLabelCache( lc, rs );
+    }
+
+}
+
+/**
+ * @brief Draws the labels of the chain obstacles cached by
+ * updateLabelCache.
+ */
+void drawLabelCache( LabelCache *lc ) {
+
+    if ( !lc->valid ) {
+        return;
+    }
+
+    // render textures are stored upside down
+    Texture2D t = lc->target.texture;
+    DrawTextureRec( t, (Rectangle){ 0, 0, t.width, -t.height }, (Vector2){ 0, 0 }, WHITE );
+
+}
@@ -0,0 +1,364 @@
+/**
+ * @file Memory.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Memory tracking, arenas and frame scratch implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#define MEMORY_DEFAULT_ALIGNMENT 16
+
+/**
+ * @brief Stored right before every tracked allocation, so it can be
+ * released without knowing its size or subsystem.
+ */
+typedef struct MemoryHeader {
+    void *block;
+    size_t size;
+    MemorySubsystem subsystem;
+} MemoryHeader;
+
+// Box2D and the render thread allocate concurrently when pipelined
+typedef struct MemoryCounters {
+    atomic_llong bytes;
+    atomic_llong peakBytes;
+    atomic_llong allocations;
+    atomic_llong frees;
+} MemoryCounters;
+
+static MemoryCounters counters[MEMORY_SUBSYSTEM_COUNT];
+
+static long long frameStartAllocations[MEMORY_SUBSYSTEM_COUNT];
+static long long lastFrameAllocations[MEMORY_SUBSYSTEM_COUNT];
+static int frames = 0;
+static int warmUpEnd = MEMORY_WARM_UP_FRAMES;
+static atomic_bool warmUpRestarted;
+static int allocatingFrames = 0;
+static bool lastFrameAllocated = false;
+
+static MemoryArena *frameScratch = NULL;
+static int scratchOverflows = 0;
+
+static const char *subsystemNames[MEMORY_SUBSYSTEM_COUNT] = {
+    "box2d", "world", "render", "window", "scratch"
+};
+
+static void* allocBox2DMemory( unsigned int size, int alignment ) {
+    return allocAlignedMemory( MEMORY_SUBSYSTEM_BOX2D, size, alignment );
+}
+
+static void freeBox2DMemory( void *mem ) {
+    freeMemory( mem );
+}
+
+/**
+ * @brief Installs the tracking allocator into Box2D and creates the frame
+ * scratch. Must be called before any Box2D world is created.
+ */
+void initMemory( size_t frameScratchCapacity ) {
+
+    b2SetAllocator( allocBox2DMemory, freeBox2DMemory );
+
+    if ( frameScratch == NULL && frameScratchCapacity > 0 ) {
+        frameScratch = createMemoryArena( MEMORY_SUBSYSTEM_SCRATCH, frameScratchCapacity );
+    }
+
+}
+
+/**
+ * @brief Allocates size bytes accounted to subsystem, 16 bytes aligned.
+ */
+void* allocMemory( MemorySubsystem subsystem, size_t size ) {
+    return allocAlignedMemory( subsystem, size, MEMORY_DEFAULT_ALIGNMENT );
+}
+
+/**
+ * @brief Allocates size bytes accounted to subsystem, aligned to a power
+ * of two alignment.
+ */
+void* allocAlignedMemory( MemorySubsystem subsystem, size_t size, size_t alignment ) {
+
+    if ( alignment < MEMORY_DEFAULT_ALIGNMENT ) {
+        alignment = MEMORY_DEFAULT_ALIGNMENT;
+    }
+
+    unsigned char *block = (unsigned char*) malloc( size + alignment + sizeof( MemoryHeader ) );
+    if ( block == NULL ) {
+        TraceLog( LOG_ERROR, "MEMORY: failed to allocate %zu bytes for %s", size, subsystemNames[subsystem] );
+        return NULL;
+    }
+
+    uintptr_t address = ( (uintptr_t) ( block + sizeof( MemoryHeader ) ) + alignment - 1 ) & ~( (uintptr_t) alignment - 1 );
+    MemoryHeader *header = (MemoryHeader*) ( address - sizeof( MemoryHeader ) );
+    header->block = block;
+    header->size = size;
+    header->subsystem = subsystem;
+
+    MemoryCounters *c = &counters[subsystem];
+    long long bytes = atomic_fetch_add( &c->bytes, (long long) size ) + (long long) size;
+    long long peak = atomic_load( &c->peakBytes );
+    while ( bytes > peak && !atomic_compare_exchange_weak( &c->peakBytes, &peak, bytes ) ) {
+    }
+    atomic_fetch_add( &c->allocations, 1 );
+
+    return (void*) address;
+
+}
+
+/**
+ * @brief Releases memory allocated by allocMemory or allocAlignedMemory.
+ */
+void freeMemory( void *ptr ) {
+
+    if ( ptr == NULL ) {
+        return;
+    }
+
+    MemoryHeader *header = (MemoryHeader*) ( (unsigned char*) ptr - sizeof( MemoryHeader ) );
+    MemoryCounters *c = &counters[header->subsystem];
+    atomic_fetch_sub( &c->bytes, (long long) header->size );
+    atomic_fetch_add( &c->frees, 1 );
+
+    free( header->block );
+
+}
+
+/**
+ * @brief Creates a dinamically allocated MemoryArena struct instance
+ * with capacity bytes, accounted to subsystem.
+ */
+MemoryArena* createMemoryArena( MemorySubsystem subsystem, size_t capacity ) {
+
+    MemoryArena *arena = (MemoryArena*) allocMemory( subsystem, sizeof( MemoryArena ) );
+
+    arena->base = (unsigned char*) allocMemory( subsystem, capacity );
+    arena->capacity = arena->base != NULL ? capacity : 0;
+    arena->used = 0;
+    arena->peak = 0;
+
+    return arena;
+
+}
+
+/**
+ * @brief Destroys a MemoryArena object and its block.
+ */
+void destroyMemoryArena( MemoryArena *arena ) {
+    freeMemory( arena->base );
+    freeMemory( arena );
+}
+
+/**
+ * @brief Allocates from the arena. Returns NULL when it is full.
+ */
+void* allocMemoryArena( MemoryArena *arena, size_t size, size_t alignment ) {
+
+    if ( alignment < sizeof( void* ) ) {
+        alignment = sizeof( void* );
+    }
+
+    // the base is 16 bytes aligned, so aligning the offset is enough
+    // for alignments up to that
+    size_t offset = ( arena->used + alignment - 1 ) & ~( alignment - 1 );
+    if ( offset + size > arena->capacity ) {
+        return NULL;
+    }
+
+    arena->used = offset + size;
+    if ( arena->used > arena->peak ) {
+        arena->peak = arena->used;
+    }
+
+    return arena->base + offset;
+
+}
+
+/**
+ * @brief Releases every allocation of the arena, keeping its block.
+ */
+void resetMemoryArena( MemoryArena *arena ) {
+    arena->used = 0;
+}
+
+/**
+ * @brief Returns the current top of the frame scratch.
+ */
+size_t getFrameScratchMark( void ) {
+    return frameScratch != NULL ? frameScratch->used : 0;
+}
+
+/**
+ * @brief Allocates a temporary from the frame scratch. Returns NULL when
+ * the scratch is full or wasn't initialized.
+ */
+void* allocFrameScratch( size_t size ) {
+
+    if ( frameScratch == NULL ) {
+        return NULL;
+    }
+
+    void *ptr = allocMemoryArena( frameScratch, size, MEMORY_DEFAULT_ALIGNMENT );
+    if ( ptr == NULL ) {
+        scratchOverflows++;
+    }
+
+    return ptr;
+
+}
+
+/**
+ * @brief Releases the frame scratch allocations made after mark.
+ */
+void releaseFrameScratch( size_t mark ) {
+    if ( frameScratch != NULL && mark <= frameScratch->used ) {
+        frameScratch->used = mark;
+    }
+}
+
+/**
+ * @brief Starts counting the heap allocations of a frame.
+ */
+void beginMemoryFrame( void ) {
+
+    for ( int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++ ) {
+        frameStartAllocations[i] = atomic_load( &counters[i].allocations );
+    }
+
+    if ( frameScratch != NULL ) {
+        resetMemoryArena( frameScratch );
+    }
+
+}
+
+/**
+ * @brief Stops counting the heap allocations of a frame. Frames past the
+ * warm up that allocated are counted and the first one of each sequence
+ * is logged.
+ */
+void endMemoryFrame( void ) {
+
+    long long total = 0;
+
+    for ( int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++ ) {
+        lastFrameAllocations[i] = atomic_load( &counters[i].allocations ) - frameStartAllocations[i];
+        total += lastFrameAllocations[i];
+    }
+
+    frames++;
+
+    if ( atomic_exchange( &warmUpRestarted, false ) ) {
+        warmUpEnd = frames + MEMORY_WARM_UP_FRAMES;
+    }
+
+    if ( total > 0 && frames > warmUpEnd ) {
+        allocatingFrames++;
+        if ( !lastFrameAllocated ) {
+            TraceLog(
+                LOG_WARNING, "MEMORY: %lld heap allocations in frame %d (box2d %lld, world %lld, render %lld, window %lld, scratch %lld)",
+                total, frames,
+                lastFrameAllocations[MEMORY_SUBSYSTEM_BOX2D], lastFrameAllocations[MEMORY_SUBSYSTEM_WORLD],
+                lastFrameAllocations[MEMORY_SUBSYSTEM_RENDER], lastFrameAllocations[MEMORY_SUBSYSTEM_WINDOW],
+                lastFrameAllocations[MEMORY_SUBSYSTEM_SCRATCH]
+            );
+        }
+    }
+
+    lastFrameAllocated = total > 0;
+
+}
+
+/**
+ * @brief Starts a new warm up, e.g. after a level is loaded. Can be
+ * called from any thread.
+ */
+void restartMemoryWarmUp( void ) {
+    atomic_store( &warmUpRestarted, true );
+}
+
+/**
+ * @brief Reads the current counters.
+ */
+MemoryReport getMemoryReport( void ) {
+
+    MemoryReport report = { 0 };
+
+    for ( int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++ ) {
+        MemorySubsystemStats *s = &report.subsystems[i];
+        s->bytes = atomic_load( &counters[i].bytes );
+        s->peakBytes = atomic_load( &counters[i].peakBytes );
+        s->allocations = atomic_load( &counters[i].allocations );
+        s->frees = atomic_load( &counters[i].frees );
+        s->frameAllocations = lastFrameAllocations[i];
+        report.bytes += s->bytes;
+        report.blocks += s->allocations - s->frees;
+        report.frameAllocations += s->frameAllocations;
+    }
+
+    report.frames = frames;
+    report.allocatingFrames = allocatingFrames;
+    report.scratchCapacity = frameScratch != NULL ? frameScratch->capacity : 0;
+    report.scratchPeak = frameScratch != NULL ? frameScratch->peak : 0;
+    report.scratchOverflows = scratchOverflows;
+
+    return report;
+
+}
+
+/**
+ * @brief Draws the bytes and allocations per subsystem.
+ */
+void drawMemoryStats( int x, int y ) {
+
+    MemoryReport r = getMemoryReport();
+
+    DrawText(
+        TextFormat(
+            "memory: %lld KB in %lld blocks (box2d %lld KB, world %lld KB, render %lld KB) frame allocs: %lld allocating frames: %d scratch: %zu KB peak",
+            r.bytes / 1024, r.blocks,
+            r.subsystems[MEMORY_SUBSYSTEM_BOX2D].bytes / 1024,
+            r.subsystems[MEMORY_SUBSYSTEM_WORLD].bytes / 1024,
+            r.subsystems[MEMORY_SUBSYSTEM_RENDER].bytes / 1024,
+            r.frameAllocations, r.allocatingFrames, r.scratchPeak / 1024
+        ),
+        x, y, 10, DARKGRAY
+    );
+
+}
+
+/**
+ * @brief Logs the bytes and allocations per subsystem.
+ */
+void logMemoryReport( void ) {
+
+    MemoryReport r = getMemoryReport();
+
+    TraceLog( LOG_INFO, "MEMORY: %lld bytes in %lld blocks, %d of %d frames allocated", r.bytes, r.blocks, r.allocatingFrames, r.frames );
+
+    for ( int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++ ) {
+        const MemorySubsystemStats *s = &r.subsystems[i];
+        TraceLog(
+            LOG_INFO, "MEMORY:     %-8s %lld bytes (peak %lld), %lld allocations, %lld frees",
+            subsystemNames[i], s->bytes, s->peakBytes, s->allocations, s->frees
+        );
+    }
+
+    TraceLog(
+        LOG_INFO, "MEMORY:     frame scratch peak %zu of %zu bytes, %d overflows",
+        r.scratchPeak, r.scratchCapacity, r.scratchOverflows
+    );
+
+}
+
+const char* getMemorySubsystemName( MemorySubsystem subsystem ) {
+    return subsystemNames[subsystem];
+}
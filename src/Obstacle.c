@@ -1,4 +1,6 @@
 #include <assert.h>
+#include <stdbool.h>
+#include <math.h>
 
 #include "Obstacle.h"
 #include "Types.h"
@@ -6,35 +8,92 @@
 #include "raylib/raylib.h"
 #include "box2d/box2d.h"
 
-void createObstacle( float x, float y, float w, float h, Color color, GameWorld *gw ) {
+static Obstacle *createObstacleBody( float x, float y, float w, float h, Color color, unsigned int flags, b2BodyType type, GameWorld *gw ) {
 
     assert( gw->obstaclesQuantity < MAX_OBSTACLES );
 
     Obstacle *o = &gw->obstacles[gw->obstaclesQuantity++];
 
     b2BodyDef bodyDef = b2DefaultBodyDef();
-    bodyDef.type = b2_staticBody;
-    bodyDef.userData = "obstacle";
+    bodyDef.type = type;
+    bodyDef.userData = o;
     bodyDef.position = (b2Vec2){ x, y };
+    if ( type == b2_dynamicBody ) {
+        bodyDef.sleepThreshold = gw->sleep.dynamicObstacleSleepThreshold;
+    }
     o->bodyId = b2CreateBody( gw->worldId, &bodyDef );
+    o->type = ENTITY_TYPE_OBSTACLE;
+    o->position = bodyDef.position;
+    o->rotation = b2Rot_identity;
+    o->changedTick = gw->tick;
 
     o->dim = (Vector2){ w, h };
     o->rect = b2MakeBox( o->dim.x/2, o->dim.y/2 );
 
     b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.userData = o;
+    shapeDef.enablePreSolveEvents = ( flags & SHAPE_FLAG_ONE_WAY ) != 0;
+    if ( type == b2_dynamicBody ) {
+        shapeDef.density = 1.0f;
+        shapeDef.material.friction = 0.6f;
+        shapeDef.enableHitEvents = true;
+    }
     o->shapeId = b2CreatePolygonShape( o->bodyId, &shapeDef, &o->rect );
 
     o->color = color;
+    o->flags = flags;
+    o->dynamic = type == b2_dynamicBody;
+    if ( !o->dynamic ) {
+        gw->staticRevision++;
+    }
+    o->lodLevel = PHYSICS_LOD_FULL;
 
+    if ( shapeDef.enablePreSolveEvents ) {
+        gw->oneWayPlatforms.stats.platformShapes++;
+    }
+
+    return o;
+
+}
+
+void createObstacle( float x, float y, float w, float h, Color color, unsigned int flags, GameWorld *gw ) {
+    createObstacleBody( x, y, w, h, color, flags, b2_staticBody, gw );
+}
+
+void createDynamicObstacle( float x, float y, float w, float h, Color color, GameWorld *gw ) {
+    createObstacleBody( x, y, w, h, color, SHAPE_FLAG_NONE, b2_dynamicBody, gw );
 }
 
 void drawObstacle( Obstacle *o ) {
 
-    b2Vec2 position = b2Body_GetPosition( o->bodyId );
+    b2Vec2 position = o->position;
+
+    if ( o->dynamic ) {
+        DrawRectanglePro( 
+            (Rectangle){ position.x, position.y, o->dim.x, o->dim.y },
+            (Vector2) { o->dim.x / 2, o->dim.y / 2 }, 
+            RAD2DEG * b2Rot_GetAngle( o->rotation ),
+            o->color
+        );
+        return;
+    }
 
     DrawRectangle( 
         position.x - o->dim.x/2, position.y - o->dim.y / 2, 
         o->dim.x, o->dim.y, o->color
     );
 
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Same test as the Box2D sleep: the linear speed and the speed of
+ * the farthest corner due to the rotation are below the sleep threshold
+ * of the body. Bodies put to sleep by hand must pass it, or they freeze
+ * with their island while still moving.
+ */
+bool isObstacleSlow( const Obstacle *o ) {
+    float threshold = b2Body_GetSleepThreshold( o->bodyId );
+    float extent = b2Length( (b2Vec2){ o->dim.x / 2, o->dim.y / 2 } );
+    return b2Length( b2Body_GetLinearVelocity( o->bodyId ) ) < threshold &&
+           fabsf( b2Body_GetAngularVelocity( o->bodyId ) ) * extent < threshold;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file OneWayPlatform.c
+ * @author Prof. Dr. David Buzatto
+ * @brief One way platform implementation.
+ *
+ * Box2D only calls the presolve callback for the contacts where one of
+ * the shapes has presolve events enabled, and only the platform shapes
+ * enable them, so the pairs without a platform never pay for it. The
+ * callback runs on the solver threads: it only reads the shapes, the
+ * manifold and the flags of the obstacles, which don't change during
+ * the step.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "OneWayPlatform.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+static bool preSolveOneWayPlatform( b2ShapeId shapeIdA, b2ShapeId shapeIdB, b2Manifold *manifold, void *context ) {
+
+    OneWayPlatforms *owp = (OneWayPlatforms*) context;
+    atomic_fetch_add_explicit( &owp->preSolveCalls, 1, memory_order_relaxed );
+
+    unsigned int flagsA = getShapeFlags( shapeIdA );
+    unsigned int flagsB = getShapeFlags( shapeIdB );
+
+    if ( ( ( flagsA | flagsB ) & SHAPE_FLAG_ONE_WAY ) == 0 ) {
+        return true;
+    }
+
+    // the normal points from A to B and up is negative y, so it must
+    // point up from the platform to the other body
+    float up = ( flagsA & SHAPE_FLAG_ONE_WAY ) != 0 ? -manifold->normal.y : manifold->normal.y;
+    bool keep = up >= owp->minNormal;
+
+    for ( int i = 0; i < manifold->pointCount && keep; i++ ) {
+        keep = manifold->points[i].separation >= -owp->maxPenetration;
+    }
+
+    if ( !keep ) {
+        atomic_fetch_add_explicit( &owp->disabledContacts, 1, memory_order_relaxed );
+    }
+
+    return keep;
+
+}
+
+/**
+ * @brief Initializes the one way platforms and registers their presolve
+ * callback in the world.
+ */
+void initOneWayPlatforms( OneWayPlatforms *owp, b2WorldId worldId ) {
+
+    // about 45 degrees of slope
+    owp->minNormal = 0.7f;
+    owp->maxPenetration = 0.03f * b2GetLengthUnitsPerMeter();
+
+    atomic_init( &owp->preSolveCalls, 0 );
+    atomic_init( &owp->disabledContacts, 0 );
+
+    owp->stats.platformShapes = 0;
+    owp->stats.preSolveCalls = 0;
+    owp->stats.disabledContacts = 0;
+    owp->stats.collideTime = 0.0f;
+
+    setOneWayPlatformsEnabled( owp, worldId, true );
+
+}
+
+/**
+ * @brief Registers or removes the presolve callback. Without it the one
+ * way platforms are solid.
+ */
+void setOneWayPlatformsEnabled( OneWayPlatforms *owp, b2WorldId worldId, bool enabled ) {
+    owp->stats.enabled = enabled;
+    b2World_SetPreSolveCallback( worldId, enabled ? preSolveOneWayPlatform : NULL, owp );
+}
+
+/**
+ * @brief Collects the counters of the last step, to be called after
+ * b2World_Step.
+ */
+void updateOneWayPlatformStats( OneWayPlatforms *owp, b2WorldId worldId ) {
+    owp->stats.preSolveCalls = atomic_exchange_explicit( &owp->preSolveCalls, 0, memory_order_relaxed );
+    owp->stats.disabledContacts = atomic_exchange_explicit( &owp->disabledContacts, 0, memory_order_relaxed );
+    // the callback runs inside the narrow phase
+    owp->stats.collideTime = b2World_GetProfile( worldId ).collide;
+}
+
+/**
+ * @brief Returns the ShapeFlag bits of the obstacle that owns a shape.
+ * Only reads the shape and the obstacle, so it is safe to call from the
+ * solver threads.
+ */
+unsigned int getShapeFlags( b2ShapeId shapeId ) {
+
+    EntityType *type = (EntityType*) b2Shape_GetUserData( shapeId );
+
+    if ( type == NULL ) {
+        return SHAPE_FLAG_NONE;
+    }
+
+    switch ( *type ) {
+        case ENTITY_TYPE_OBSTACLE:
+            return ( (Obstacle*) type )->flags;
+        case ENTITY_TYPE_CHAIN_OBSTACLE:
+            return ( (ChainObstacle*) type )->flags;
+        default:
+            return SHAPE_FLAG_NONE;
+    }
+
+}
+
+/**
+ * @brief Draws the one way platform counters.
+ */
+void drawOneWayPlatformStats( const OneWayPlatformStats *stats, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "one way platforms %s (O): %d shapes, %d presolve calls, %d contacts disabled, collide %.3fms",
+            stats->enabled ? "on" : "off", stats->platformShapes,
+            stats->preSolveCalls, stats->disabledContacts, stats->collideTime
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
@@ -0,0 +1,397 @@
+/**
+ * @file ParticleSystem.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Particle system implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#if defined( __SSE__ )
+#include <xmmintrin.h>
+#endif
+
+#include "ParticleSystem.h"
+#include "InstancedRenderer.h"
+#include "Memory.h"
+#include "Random.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+#define RAYMATH_STATIC_INLINE
+#include "raylib/raymath.h"
+
+// the arrays are padded to whole SIMD lanes
+#define PARTICLE_LANES 4
+#define PARTICLE_ALIGNMENT 64
+
+// spread, in radians, of the particles of a burst around its direction
+#define PARTICLE_SPREAD 1.6f
+
+static const char *vertexShaderCode =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in float instanceX;\n"
+    "in float instanceY;\n"
+    "in float instanceLife;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "uniform float size;\n"
+    "uniform float fadeTime;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vec4( instanceColor.rgb, instanceColor.a * clamp( instanceLife / fadeTime, 0.0, 1.0 ) );\n"
+    "    gl_Position = mvp * vec4( vec2( instanceX, instanceY ) + vertexPosition * size, 0.0, 1.0 );\n"
+    "}\n";
+
+static const char *fragmentShaderCode =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+static unsigned int loadInstanceBuffer( int location, int size, int type, bool normalized, int capacity, int elementSize ) {
+
+    unsigned int vboId = rlLoadVertexBuffer( NULL, elementSize * capacity, true );
+    rlSetVertexAttribute( location, size, type, normalized, 0, 0 );
+    rlEnableVertexAttribute( location );
+    rlSetVertexAttributeDivisor( location, 1 );
+
+    return vboId;
+
+}
+
+/*
+ * Integrates velocities and positions and ages the particles, returning
+ * whether some particle died. Branch free, so the SSE path handles four
+ * particles per iteration.
+ */
+static bool integrateParticles( ParticleSystem *ps, float delta ) {
+
+    float * restrict x = ps->x;
+    float * restrict y = ps->y;
+    float * restrict vx = ps->vx;
+    float * restrict vy = ps->vy;
+    float * restrict life = ps->life;
+
+    float damping = 1.0f - ps->damping * delta;
+    if ( damping < 0.0f ) {
+        damping = 0.0f;
+    }
+    float gravity = ps->gravity * delta;
+
+    int quantity = ps->quantity;
+    int i = 0;
+    int dead = 0;
+
+#if defined( __SSE__ )
+
+    __m128 dt = _mm_set1_ps( delta );
+    __m128 k = _mm_set1_ps( damping );
+    __m128 g = _mm_set1_ps( gravity );
+    __m128 zero = _mm_setzero_ps();
+    int lanes = ( quantity + PARTICLE_LANES - 1 ) & ~( PARTICLE_LANES - 1 );
+
+    // the padding lanes past quantity are updated too, a long life keeps
+    // them from counting as dead
+    for ( int j = quantity; j < lanes; j++ ) {
+        life[j] = 1.0e9f;
+    }
+
+    for ( ; i < lanes; i += PARTICLE_LANES ) {
+
+        __m128 nvx = _mm_mul_ps( _mm_load_ps( vx + i ), k );
+        __m128 nvy = _mm_add_ps( _mm_mul_ps( _mm_load_ps( vy + i ), k ), g );
+        __m128 nl = _mm_sub_ps( _mm_load_ps( life + i ), dt );
+
+        _mm_store_ps( vx + i, nvx );
+        _mm_store_ps( vy + i, nvy );
+        _mm_store_ps( x + i, _mm_add_ps( _mm_load_ps( x + i ), _mm_mul_ps( nvx, dt ) ) );
+        _mm_store_ps( y + i, _mm_add_ps( _mm_load_ps( y + i ), _mm_mul_ps( nvy, dt ) ) );
+        _mm_store_ps( life + i, nl );
+
+        dead |= _mm_movemask_ps( _mm_cmple_ps( nl, zero ) );
+
+    }
+
+#endif
+
+    for ( ; i < quantity; i++ ) {
+        vx[i] *= damping;
+        vy[i] = vy[i] * damping + gravity;
+        x[i] += vx[i] * delta;
+        y[i] += vy[i] * delta;
+        life[i] -= delta;
+        dead |= life[i] <= 0.0f;
+    }
+
+    return dead != 0;
+
+}
+
+/*
+ * Replaces each dead particle with the last live one.
+ */
+static void killParticles( ParticleSystem *ps ) {
+
+    int i = 0;
+
+    while ( i < ps->quantity ) {
+
+        if ( ps->life[i] > 0.0f ) {
+            i++;
+            continue;
+        }
+
+        int last = --ps->quantity;
+        ps->x[i] = ps->x[last];
+        ps->y[i] = ps->y[last];
+        ps->vx[i] = ps->vx[last];
+        ps->vy[i] = ps->vy[last];
+        ps->life[i] = ps->life[last];
+        ps->color[i] = ps->color[last];
+        ps->killed++;
+
+    }
+
+}
+
+/**
+ * @brief Creates a dinamically allocated ParticleSystem struct instance
+ * holding up to capacity particles. Needs an OpenGL context to draw,
+ * without one (or its shader) the particles are drawn one by one.
+ */
+ParticleSystem* createParticleSystem( int capacity, float gravity ) {
+
+    ParticleSystem *ps = (ParticleSystem*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( ParticleSystem ) );
+
+    capacity = ( capacity + PARTICLE_LANES - 1 ) & ~( PARTICLE_LANES - 1 );
+    size_t size = sizeof( float ) * capacity;
+
+    ps->x = (float*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, size, PARTICLE_ALIGNMENT );
+    ps->y = (float*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, size, PARTICLE_ALIGNMENT );
+    ps->vx = (float*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, size, PARTICLE_ALIGNMENT );
+    ps->vy = (float*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, size, PARTICLE_ALIGNMENT );
+    ps->life = (float*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, size, PARTICLE_ALIGNMENT );
+    ps->color = (Color*) allocAlignedMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( Color ) * capacity, PARTICLE_ALIGNMENT );
+
+    // the padding lanes are integrated, garbage there could be denormals
+    memset( ps->x, 0, size );
+    memset( ps->y, 0, size );
+    memset( ps->vx, 0, size );
+    memset( ps->vy, 0, size );
+    memset( ps->life, 0, size );
+
+    ps->capacity = capacity;
+    ps->quantity = 0;
+    ps->gravity = gravity;
+    ps->damping = 1.5f;
+    ps->size = 3.0f;
+    ps->seed = 0x9e3779b9u;
+    ps->emitterTotal = 0;
+
+    ps->spawned = 0;
+    ps->killed = 0;
+    ps->dropped = 0;
+    ps->drawCalls = 0;
+    ps->updateTime = 0.0;
+
+    ps->shaderId = rlLoadShaderCode( vertexShaderCode, fragmentShaderCode );
+    ps->ready = ps->shaderId != 0 && ps->shaderId != rlGetShaderIdDefault();
+
+    if ( !ps->ready ) {
+        TraceLog( LOG_WARNING, "PARTICLES: shader not available, using immediate mode" );
+        ps->vaoId = 0;
+        return ps;
+    }
+
+    ps->mvpLoc = rlGetLocationUniform( ps->shaderId, "mvp" );
+    ps->sizeLoc = rlGetLocationUniform( ps->shaderId, "size" );
+    ps->fadeLoc = rlGetLocationUniform( ps->shaderId, "fadeTime" );
+
+    ps->vaoId = rlLoadVertexArray();
+    rlEnableVertexArray( ps->vaoId );
+
+    int positionLoc = rlGetLocationAttrib( ps->shaderId, "vertexPosition" );
+    ps->quadVboId = rlLoadVertexBuffer( unitQuadVertices, sizeof( unitQuadVertices ), false );
+    rlSetVertexAttribute( positionLoc, 2, RL_FLOAT, false, 0, 0 );
+    rlEnableVertexAttribute( positionLoc );
+
+    // one buffer per array, uploaded as they are
+    ps->xVboId = loadInstanceBuffer( rlGetLocationAttrib( ps->shaderId, "instanceX" ), 1, RL_FLOAT, false, capacity, sizeof( float ) );
+    ps->yVboId = loadInstanceBuffer( rlGetLocationAttrib( ps->shaderId, "instanceY" ), 1, RL_FLOAT, false, capacity, sizeof( float ) );
+    ps->lifeVboId = loadInstanceBuffer( rlGetLocationAttrib( ps->shaderId, "instanceLife" ), 1, RL_FLOAT, false, capacity, sizeof( float ) );
+    ps->colorVboId = loadInstanceBuffer( rlGetLocationAttrib( ps->shaderId, "instanceColor" ), 4, RL_UNSIGNED_BYTE, true, capacity, sizeof( Color ) );
+
+    rlDisableVertexArray();
+
+    return ps;
+
+}
+
+/**
+ * @brief Destroys a ParticleSystem object and its GPU resources.
+ */
+void destroyParticleSystem( ParticleSystem *ps ) {
+
+    if ( ps->ready ) {
+        rlUnloadVertexBuffer( ps->colorVboId );
+        rlUnloadVertexBuffer( ps->lifeVboId );
+        rlUnloadVertexBuffer( ps->yVboId );
+        rlUnloadVertexBuffer( ps->xVboId );
+        rlUnloadVertexBuffer( ps->quadVboId );
+        rlUnloadVertexArray( ps->vaoId );
+        rlUnloadShaderProgram( ps->shaderId );
+    }
+
+    freeMemory( ps->x );
+    freeMemory( ps->y );
+    freeMemory( ps->vx );
+    freeMemory( ps->vy );
+    freeMemory( ps->life );
+    freeMemory( ps->color );
+    freeMemory( ps );
+
+}
+
+/**
+ * @brief Spawns the particles of a burst. Particles that don't fit are
+ * dropped.
+ */
+void emitParticles( ParticleSystem *ps, const ParticleEmitter *emitter ) {
+
+    int quantity = emitter->quantity;
+    if ( quantity > ps->capacity - ps->quantity ) {
+        ps->dropped += quantity - ( ps->capacity - ps->quantity );
+        quantity = ps->capacity - ps->quantity;
+    }
+
+    float angle = atan2f( emitter->direction.y, emitter->direction.x );
+
+    for ( int i = 0; i < quantity; i++ ) {
+
+        int p = ps->quantity++;
+        float a = angle + PARTICLE_SPREAD * ( nextRandomFloat( &ps->seed ) - 0.5f );
+        float speed = emitter->speed * ( 0.3f + 0.7f * nextRandomFloat( &ps->seed ) );
+
+        ps->x[p] = emitter->position.x;
+        ps->y[p] = emitter->position.y;
+        ps->vx[p] = cosf( a ) * speed;
+        ps->vy[p] = sinf( a ) * speed;
+        ps->life[p] = 0.4f + 0.6f * nextRandomFloat( &ps->seed );
+        ps->color[p] = emitter->color;
+
+    }
+
+    ps->spawned += quantity;
+
+}
+
+/**
+ * @brief Spawns the bursts of the snapshot that weren't spawned yet.
+ */
+void emitSnapshotParticles( ParticleSystem *ps, const RenderSnapshot *rs ) {
+
+    // a new world starts counting again
+    if ( rs->particleEmitterTotal < ps->emitterTotal ) {
+        ps->emitterTotal = rs->particleEmitterTotal;
+    }
+
+    int first = ps->emitterTotal;
+    if ( rs->particleEmitterTotal - first > PARTICLE_EMITTER_HISTORY ) {
+        first = rs->particleEmitterTotal - PARTICLE_EMITTER_HISTORY;
+    }
+
+    for ( int i = first; i < rs->particleEmitterTotal; i++ ) {
+        emitParticles( ps, &rs->particleEmitters[i % PARTICLE_EMITTER_HISTORY] );
+    }
+
+    ps->emitterTotal = rs->particleEmitterTotal;
+
+}
+
+/**
+ * @brief Moves the particles delta seconds forward and removes the ones
+ * whose life ended.
+ */
+void updateParticleSystem( ParticleSystem *ps, float delta ) {
+
+    double start = GetTime();
+
+    ps->killed = 0;
+
+    if ( integrateParticles( ps, delta ) ) {
+        killParticles( ps );
+    }
+
+    ps->updateTime = ( GetTime() - start ) * 1000.0;
+
+}
+
+/**
+ * @brief Draws the live particles.
+ */
+void drawParticleSystem( ParticleSystem *ps ) {
+
+    ps->drawCalls = 0;
+
+    if ( ps->quantity == 0 ) {
+        return;
+    }
+
+    if ( !ps->ready ) {
+        for ( int i = 0; i < ps->quantity; i++ ) {
+            float fade = ps->life[i] < PARTICLE_FADE_TIME ? ps->life[i] / PARTICLE_FADE_TIME : 1.0f;
+            DrawRectangleV(
+                (Vector2){ ps->x[i] - ps->size / 2, ps->y[i] - ps->size / 2 },
+                (Vector2){ ps->size, ps->size },
+                Fade( ps->color[i], fade )
+            );
+        }
+        return;
+    }
+
+    float fadeTime = PARTICLE_FADE_TIME;
+
+    // keeps the order with what was drawn through raylib before
+    rlDrawRenderBatchActive();
+
+    rlEnableShader( ps->shaderId );
+    rlSetUniformMatrix( ps->mvpLoc, MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() ) );
+    rlSetUniform( ps->sizeLoc, &ps->size, RL_SHADER_UNIFORM_FLOAT, 1 );
+    rlSetUniform( ps->fadeLoc, &fadeTime, RL_SHADER_UNIFORM_FLOAT, 1 );
+
+    rlUpdateVertexBuffer( ps->xVboId, ps->x, sizeof( float ) * ps->quantity, 0 );
+    rlUpdateVertexBuffer( ps->yVboId, ps->y, sizeof( float ) * ps->quantity, 0 );
+    rlUpdateVertexBuffer( ps->lifeVboId, ps->life, sizeof( float ) * ps->quantity, 0 );
+    rlUpdateVertexBuffer( ps->colorVboId, ps->color, sizeof( Color ) * ps->quantity, 0 );
+
+    rlEnableVertexArray( ps->vaoId );
+    rlDrawVertexArrayInstanced( 0, UNIT_QUAD_VERTEX_QUANTITY, ps->quantity );
+    rlDisableVertexArray();
+
+    rlDisableShader();
+
+    ps->drawCalls++;
+
+}
+
+/**
+ * @brief Draws the particle counters.
+ */
+void drawParticleStats( const ParticleSystem *ps, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "particles: %d/%d live, %d spawned, %d killed, %d dropped, update %.3fms, %d draw calls (P: fountain)",
+            ps->quantity, ps->capacity, ps->spawned, ps->killed, ps->dropped, ps->updateTime, ps->drawCalls
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
@@ -0,0 +1,197 @@
+/**
+ * @file PhysicsLOD.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation level of detail implementation.
+ *
+ * Box2D steps every awake body of a world with the same time step, so
+ * distant bodies are not stepped at a lower rate: once slow, they are
+ * kept asleep in the middle ring (no solver cost, still collidable),
+ * moving ones are left to settle on their own, and disabled in
+ * the outer ring (no broadphase nor solver cost). Velocities are kept by
+ * Box2D, so promoted bodies resume their motion.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "PhysicsLOD.h"
+#include "Obstacle.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+static PhysicsLODLevel targetLevel( const PhysicsLOD *lod, PhysicsLODLevel current, float distance ) {
+
+    float h = lod->hysteresis;
+
+    switch ( current ) {
+        case PHYSICS_LOD_FULL:
+            if ( distance > lod->disableRadius + h ) {
+                return PHYSICS_LOD_DISABLED;
+            }
+            if ( distance > lod->sleepRadius + h ) {
+                return PHYSICS_LOD_SLEEPING;
+            }
+            break;
+        case PHYSICS_LOD_SLEEPING:
+            if ( distance < lod->sleepRadius - h ) {
+                return PHYSICS_LOD_FULL;
+            }
+            if ( distance > lod->disableRadius + h ) {
+                return PHYSICS_LOD_DISABLED;
+            }
+            break;
+        case PHYSICS_LOD_DISABLED:
+            if ( distance < lod->sleepRadius - h ) {
+                return PHYSICS_LOD_FULL;
+            }
+            if ( distance < lod->disableRadius - h ) {
+                return PHYSICS_LOD_SLEEPING;
+            }
+            break;
+    }
+
+    return current;
+
+}
+
+static void applyLevel( Obstacle *o, PhysicsLODLevel level ) {
+
+    if ( o->lodLevel == PHYSICS_LOD_DISABLED && level != PHYSICS_LOD_DISABLED ) {
+        b2Body_Enable( o->bodyId );
+    }
+
+    switch ( level ) {
+        case PHYSICS_LOD_FULL:
+            b2Body_SetAwake( o->bodyId, true );
+            break;
+        case PHYSICS_LOD_SLEEPING:
+            // a moving body (and its island) would freeze mid-air, it is
+            // left to the Box2D sleep and put to sleep once it is slow
+            if ( isObstacleSlow( o ) ) {
+                b2Body_SetAwake( o->bodyId, false );
+            }
+            break;
+        case PHYSICS_LOD_DISABLED:
+            if ( o->lodLevel != PHYSICS_LOD_DISABLED ) {
+                b2Body_Disable( o->bodyId );
+            }
+            break;
+    }
+
+    o->lodLevel = level;
+
+}
+
+/**
+ * @brief Initializes the level of detail rings.
+ */
+void initPhysicsLOD( PhysicsLOD *lod, float sleepRadius, float disableRadius, float hysteresis, int budget ) {
+
+    lod->enabled = true;
+    lod->sleepRadius = sleepRadius;
+    lod->disableRadius = disableRadius;
+    lod->hysteresis = hysteresis;
+    lod->budget = budget;
+    lod->cursor = 0;
+
+    lod->fullQuantity = 0;
+    lod->sleepingQuantity = 0;
+    lod->disabledQuantity = 0;
+    lod->transitions = 0;
+
+}
+
+/**
+ * @brief Evaluates up to lod->budget dynamic obstacles against the rings
+ * centered at focus, demoting or promoting them as needed.
+ */
+void updatePhysicsLOD( PhysicsLOD *lod, GameWorld *gw, b2Vec2 focus ) {
+
+    lod->transitions = 0;
+
+    if ( !lod->enabled || gw->obstaclesQuantity == 0 ) {
+        return;
+    }
+
+    int evaluations = lod->budget < gw->obstaclesQuantity ? lod->budget : gw->obstaclesQuantity;
+
+    for ( int i = 0; i < evaluations; i++ ) {
+
+        if ( lod->cursor >= gw->obstaclesQuantity ) {
+            lod->cursor = 0;
+        }
+
+        Obstacle *o = &gw->obstacles[lod->cursor++];
+        if ( !o->dynamic ) {
+            continue;
+        }
+
+        float distance = b2Distance( b2Body_GetPosition( o->bodyId ), focus );
+        PhysicsLODLevel level = targetLevel( lod, o->lodLevel, distance );
+
+        if ( level != o->lodLevel ) {
+            applyLevel( o, level );
+            lod->transitions++;
+        } else if ( level == PHYSICS_LOD_SLEEPING && b2Body_IsAwake( o->bodyId ) ) {
+            // still moving when demoted or woken up by a contact with an
+            // active body
+            applyLevel( o, level );
+        }
+
+    }
+
+    lod->fullQuantity = 0;
+    lod->sleepingQuantity = 0;
+    lod->disabledQuantity = 0;
+
+    for ( int i = 0; i < gw->obstaclesQuantity; i++ ) {
+        if ( gw->obstacles[i].dynamic ) {
+            switch ( gw->obstacles[i].lodLevel ) {
+                case PHYSICS_LOD_FULL: lod->fullQuantity++; break;
+                case PHYSICS_LOD_SLEEPING: lod->sleepingQuantity++; break;
+                case PHYSICS_LOD_DISABLED: lod->disabledQuantity++; break;
+            }
+        }
+    }
+
+}
+
+/**
+ * @brief Enables or disables the level of detail system. Disabling it
+ * promotes every body back to full rate simulation.
+ */
+void setPhysicsLODEnabled( PhysicsLOD *lod, GameWorld *gw, bool enabled ) {
+
+    lod->enabled = enabled;
+
+    if ( !enabled ) {
+        for ( int i = 0; i < gw->obstaclesQuantity; i++ ) {
+            Obstacle *o = &gw->obstacles[i];
+            if ( o->dynamic && o->lodLevel != PHYSICS_LOD_FULL ) {
+                applyLevel( o, PHYSICS_LOD_FULL );
+            }
+        }
+        lod->fullQuantity += lod->sleepingQuantity + lod->disabledQuantity;
+        lod->sleepingQuantity = 0;
+        lod->disabledQuantity = 0;
+    }
+
+}
+
+/**
+ * @brief Draws the level of detail counters.
+ */
+void drawPhysicsLODStats( const PhysicsLOD *lod, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "lod %s: full: %d sleeping: %d disabled: %d transitions: %d",
+            lod->enabled ? "on" : "off",
+            lod->fullQuantity, lod->sleepingQuantity, lod->disabledQuantity, lod->transitions
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
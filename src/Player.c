@@ -8,10 +8,15 @@ void createPlayer( Player *p, float x, float y, float w, float h, Color color, G
 
     b2BodyDef bodyDef = b2DefaultBodyDef();
     bodyDef.type = b2_dynamicBody;
-    bodyDef.userData = "player";
+    bodyDef.userData = p;
     bodyDef.position = (b2Vec2){ x, y };
     bodyDef.fixedRotation = true;
+    bodyDef.sleepThreshold = gw->sleep.playerSleepThreshold;
     p->bodyId = b2CreateBody( gw->worldId, &bodyDef );
+    p->type = ENTITY_TYPE_PLAYER;
+    p->position = bodyDef.position;
+    p->rotation = b2Rot_identity;
+    p->changedTick = gw->tick;
 
     p->dim = (Vector2){ w, h };
     p->rect = b2MakeBox( p->dim.x/2, p->dim.y/2 );
@@ -19,6 +24,7 @@ void createPlayer( Player *p, float x, float y, float w, float h, Color color, G
     b2ShapeDef shapeDef = b2DefaultShapeDef();
     shapeDef.density = 1.0f;
     shapeDef.material.friction = 0.05f;
+    shapeDef.enableHitEvents = true;
 
     p->shapeId = b2CreatePolygonShape( p->bodyId, &shapeDef, &p->rect );
 
@@ -31,21 +37,21 @@ void createPlayer( Player *p, float x, float y, float w, float h, Color color, G
 
 }
 
-void updatePlayer( Player *p ) {
+void updatePlayer( Player *p, const GameInput *input ) {
 
-    if ( IsKeyDown( KEY_RIGHT ) || IsKeyDown( KEY_D ) ) {
+    if ( input->moveRight ) {
         if ( b2Body_GetLinearVelocity( p->bodyId ).x < p->maxWalkVelocity ) {
             b2Body_ApplyForceToCenter( p->bodyId, (b2Vec2){ p->walkImpulse, 0 }, true );
         }
     }
 
-    if ( IsKeyDown( KEY_LEFT ) || IsKeyDown( KEY_A ) ) {
+    if ( input->moveLeft ) {
         if ( b2Body_GetLinearVelocity( p->bodyId ).x > -p->maxWalkVelocity ) {
             b2Body_ApplyForceToCenter( p->bodyId, (b2Vec2){ -p->walkImpulse, 0 }, true );
         }
     }
 
-    if ( IsKeyPressed( KEY_SPACE ) ) {
+    if ( input->jump ) {
         b2Body_ApplyLinearImpulseToCenter( p->bodyId, (b2Vec2){ 0, p->jumpImpulse }, true );
     }
 
@@ -53,12 +59,9 @@ void updatePlayer( Player *p ) {
 
 void drawPlayer( Player *p ) {
 
-    b2Vec2 position = b2Body_GetPosition( p->bodyId );
-    b2Rot rotation = b2Body_GetRotation( p->bodyId );
-    
     Rectangle rect = (Rectangle){ 
-        position.x, 
-        position.y, 
+        p->position.x, 
+        p->position.y, 
         p->dim.x, 
         p->dim.y
     };
@@ -66,7 +69,7 @@ void drawPlayer( Player *p ) {
     DrawRectanglePro( 
         rect, 
         (Vector2) { rect.width / 2, rect.height / 2 }, 
-        RAD2DEG * b2Rot_GetAngle( rotation ),
+        RAD2DEG * b2Rot_GetAngle( p->rotation ),
         p->color
     );
 
@@ -0,0 +1,1111 @@
+/**
+ * @file PolygonUtils.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Polygon cleanup and validation implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+
+#include "PolygonUtils.h"
+#include "Memory.h"
+#include "Random.h"
+
+#include "box2d/box2d.h"
+
+// sweeps of polygons up to this size don't touch the heap
+#define SWEEP_STACK_EDGES 64
+
+typedef struct SweepEvent {
+    b2Vec2 point;
+    int edge;
+    bool start;
+} SweepEvent;
+
+/**
+ * @brief Node of the sweep status, a treap ordered from bottom to top at
+ * the sweep position, indexed by edge.
+ */
+typedef struct SweepNode {
+    int left;
+    int right;
+    int parent;
+    uint32_t priority;
+} SweepNode;
+
+typedef struct SweepStatus {
+    const b2Vec2 *points;
+    int pointCount;
+    SweepNode *nodes;
+    int root;
+} SweepStatus;
+
+static float distanceToLine( b2Vec2 p, b2Vec2 a, b2Vec2 b ) {
+
+    b2Vec2 ab = b2Sub( b, a );
+    float length = b2Length( ab );
+
+    // the neighbors coincide, p is the tip of a spike
+    if ( length < FLT_EPSILON ) {
+        return 0.0f;
+    }
+
+    return fabsf( b2Cross( ab, b2Sub( p, a ) ) ) / length;
+
+}
+
+static float distanceToSegment( b2Vec2 p, b2Vec2 a, b2Vec2 b ) {
+
+    b2Vec2 ab = b2Sub( b, a );
+    float lengthSquared = b2Dot( ab, ab );
+
+    if ( lengthSquared < FLT_EPSILON ) {
+        return b2Distance( p, a );
+    }
+
+    float t = b2ClampFloat( b2Dot( b2Sub( p, a ), ab ) / lengthSquared, 0.0f, 1.0f );
+    return b2Distance( p, b2MulAdd( a, t, ab ) );
+
+}
+
+/**
+ * @brief Writes the vertices kept between first and last (exclusive) at
+ * count and returns the new count. Indices wrap around, so last can be
+ * pointCount for the closing range. A vertex is written at a position
+ * not greater than its index, after every range that starts on it was
+ * scanned, so the ranges still to be scanned are never overwritten.
+ */
+static int simplifyRange( b2Vec2 *points, int pointCount, int first, int last, float tolerance, int count ) {
+
+    b2Vec2 a = points[first % pointCount];
+    b2Vec2 b = points[last % pointCount];
+
+    int farthest = -1;
+    float maxDistance = tolerance;
+
+    for ( int i = first + 1; i < last; i++ ) {
+        float d = distanceToSegment( points[i], a, b );
+        if ( d > maxDistance ) {
+            maxDistance = d;
+            farthest = i;
+        }
+    }
+
+    if ( farthest < 0 ) {
+        return count;
+    }
+
+    b2Vec2 kept = points[farthest];
+    count = simplifyRange( points, pointCount, first, farthest, tolerance, count );
+    points[count++] = kept;
+
+    return simplifyRange( points, pointCount, farthest, last, tolerance, count );
+
+}
+
+/**
+ * @brief Merges consecutive vertices closer than tolerance, including the
+ * last and the first one. Works in place and returns the new quantity of
+ * vertices.
+ */
+int weldPolygonVertices( b2Vec2 *points, int pointCount, float tolerance ) {
+
+    if ( pointCount < 2 || tolerance <= 0.0f ) {
+        return pointCount;
+    }
+
+    int count = 1;
+
+    for ( int i = 1; i < pointCount; i++ ) {
+        if ( b2Distance( points[i], points[count-1] ) > tolerance ) {
+            points[count++] = points[i];
+        }
+    }
+
+    while ( count > 1 && b2Distance( points[count-1], points[0] ) <= tolerance ) {
+        count--;
+    }
+
+    return count;
+
+}
+
+/**
+ * @brief Removes the vertices closer than tolerance to the line through
+ * their neighbors, which also removes zero width spikes. Works in place
+ * and returns the new quantity of vertices.
+ */
+int removeCollinearVertices( b2Vec2 *points, int pointCount, float tolerance ) {
+
+    if ( pointCount < 3 || tolerance <= 0.0f ) {
+        return pointCount;
+    }
+
+    b2Vec2 first = points[0];
+    b2Vec2 last = points[pointCount-1];
+    int count = 0;
+
+    // compared with the last kept vertex, so runs of collinear vertices
+    // are removed in a single pass
+    for ( int i = 0; i < pointCount; i++ ) {
+        b2Vec2 prev = count > 0 ? points[count-1] : last;
+        b2Vec2 next = i + 1 < pointCount ? points[i+1] : first;
+        if ( distanceToLine( points[i], prev, next ) > tolerance ) {
+            points[count++] = points[i];
+        }
+    }
+
+    // the first vertex was tested against the original last one, the
+    // seam is tested again until it is stable
+    bool removed = true;
+    while ( removed && count >= 3 ) {
+
+        removed = false;
+
+        if ( distanceToLine( points[0], points[count-1], points[1] ) <= tolerance ) {
+            for ( int i = 1; i < count; i++ ) {
+                points[i-1] = points[i];
+            }
+            count--;
+            removed = true;
+        } else if ( distanceToLine( points[count-1], points[count-2], points[0] ) <= tolerance ) {
+            count--;
+            removed = true;
+        }
+
+    }
+
+    return count;
+
+}
+
+/**
+ * @brief Douglas-Peucker simplification of a closed polygon: keeps the
+ * vertices needed so no removed one is farther than tolerance from the
+ * result. Works in place and returns the new quantity of vertices.
+ */
+int simplifyPolygon( b2Vec2 *points, int pointCount, float tolerance ) {
+
+    if ( pointCount < 4 || tolerance <= 0.0f ) {
+        return pointCount;
+    }
+
+    // a closed polygon is split in two open ranges, between the first
+    // vertex and the farthest one from it
+    int farthest = 1;
+    float maxDistance = 0.0f;
+    for ( int i = 1; i < pointCount; i++ ) {
+        float d = b2DistanceSquared( points[i], points[0] );
+        if ( d > maxDistance ) {
+            maxDistance = d;
+            farthest = i;
+        }
+    }
+
+    b2Vec2 anchor = points[farthest];
+    int count = simplifyRange( points, pointCount, 0, farthest, tolerance, 1 );
+    points[count++] = anchor;
+
+    return simplifyRange( points, pointCount, farthest, pointCount, tolerance, count );
+
+}
+
+/**
+ * @brief Runs welding, collinear removal and simplification, in this
+ * order. Works in place and returns the new quantity of vertices, which
+ * can be less than 3 for degenerate input.
+ */
+int cleanupPolygon( b2Vec2 *points, int pointCount, const PolygonCleanupSettings *settings ) {
+
+    pointCount = weldPolygonVertices( points, pointCount, settings->weldTolerance );
+    pointCount = removeCollinearVertices( points, pointCount, settings->collinearTolerance );
+    pointCount = simplifyPolygon( points, pointCount, settings->simplifyTolerance );
+
+    return pointCount;
+
+}
+
+/**
+ * @brief Shoelace area, positive for clockwise polygons on the screen,
+ * with y growing down.
+ */
+float computePolygonSignedArea( const b2Vec2 *points, int pointCount ) {
+
+    float area = 0.0f;
+
+    for ( int i = 0; i < pointCount; i++ ) {
+        area += b2Cross( points[i], points[( i + 1 ) % pointCount] );
+    }
+
+    return area * 0.5f;
+
+}
+
+/**
+ * @brief Reverses the winding of a polygon, in place.
+ */
+void reversePolygon( b2Vec2 *points, int pointCount ) {
+    for ( int i = 0, j = pointCount - 1; i < j; i++, j-- ) {
+        b2Vec2 t = points[i];
+        points[i] = points[j];
+        points[j] = t;
+    }
+}
+
+static float orientation( b2Vec2 a, b2Vec2 b, b2Vec2 c ) {
+    return b2Cross( b2Sub( b, a ), b2Sub( c, a ) );
+}
+
+static int sign( float v ) {
+    return ( v > 0.0f ) - ( v < 0.0f );
+}
+
+static bool isLexicographicallyLess( b2Vec2 a, b2Vec2 b ) {
+    return a.x < b.x || ( a.x == b.x && a.y < b.y );
+}
+
+// endpoints of an edge, the lexicographically smaller first
+static void getEdge( const SweepStatus *ss, int edge, b2Vec2 *a, b2Vec2 *b ) {
+
+    b2Vec2 p = ss->points[edge];
+    b2Vec2 q = ss->points[( edge + 1 ) % ss->pointCount];
+
+    if ( isLexicographicallyLess( q, p ) ) {
+        *a = q;
+        *b = p;
+    } else {
+        *a = p;
+        *b = q;
+    }
+
+}
+
+// c is known to be on the line through a and b
+static bool isOnSegment( b2Vec2 a, b2Vec2 b, b2Vec2 c ) {
+    return c.x >= fminf( a.x, b.x ) && c.x <= fmaxf( a.x, b.x ) &&
+           c.y >= fminf( a.y, b.y ) && c.y <= fmaxf( a.y, b.y );
+}
+
+static bool intersectEdges( const SweepStatus *ss, int edgeA, int edgeB, b2Vec2 *intersection ) {
+
+    int n = ss->pointCount;
+
+    // adjacent edges share a vertex and only intersect when folding back
+    if ( edgeB == ( edgeA + 1 ) % n || edgeA == ( edgeB + 1 ) % n ) {
+        int first = edgeB == ( edgeA + 1 ) % n ? edgeA : edgeB;
+        b2Vec2 a = ss->points[first];
+        b2Vec2 shared = ss->points[( first + 1 ) % n];
+        b2Vec2 c = ss->points[( first + 2 ) % n];
+        if ( orientation( a, shared, c ) == 0.0f && b2Dot( b2Sub( a, shared ), b2Sub( c, shared ) ) > 0.0f ) {
+            *intersection = shared;
+            return true;
+        }
+        return false;
+    }
+
+    b2Vec2 a, b, c, d;
+    getEdge( ss, edgeA, &a, &b );
+    getEdge( ss, edgeB, &c, &d );
+
+    int o1 = sign( orientation( a, b, c ) );
+    int o2 = sign( orientation( a, b, d ) );
+    int o3 = sign( orientation( c, d, a ) );
+    int o4 = sign( orientation( c, d, b ) );
+
+    if ( o1 * o2 < 0 && o3 * o4 < 0 ) {
+        b2Vec2 r = b2Sub( b, a );
+        b2Vec2 s = b2Sub( d, c );
+        float t = b2Cross( b2Sub( c, a ), s ) / b2Cross( r, s );
+        *intersection = b2MulAdd( a, t, r );
+        return true;
+    }
+
+    // touching or collinear overlapping
+    if ( o1 == 0 && isOnSegment( a, b, c ) ) {
+        *intersection = c;
+        return true;
+    }
+    if ( o2 == 0 && isOnSegment( a, b, d ) ) {
+        *intersection = d;
+        return true;
+    }
+    if ( o3 == 0 && isOnSegment( c, d, a ) ) {
+        *intersection = a;
+        return true;
+    }
+    if ( o4 == 0 && isOnSegment( c, d, b ) ) {
+        *intersection = b;
+        return true;
+    }
+
+    return false;
+
+}
+
+/**
+ * @brief Order of the edges in the status when edge is inserted: by the
+ * side of the other edge where its left endpoint is, or its right one
+ * if they start on the same point.
+ */
+static int compareEdges( const SweepStatus *ss, int edge, int other ) {
+
+    b2Vec2 a, b, c, d;
+    getEdge( ss, edge, &a, &b );
+    getEdge( ss, other, &c, &d );
+
+    float o = orientation( c, d, a );
+    if ( o == 0.0f ) {
+        o = orientation( c, d, b );
+    }
+    if ( o == 0.0f ) {
+        return edge < other ? -1 : 1;
+    }
+
+    return o > 0.0f ? 1 : -1;
+
+}
+
+static int compareSweepEvents( const void *p1, const void *p2 ) {
+
+    const SweepEvent *e1 = (const SweepEvent*) p1;
+    const SweepEvent *e2 = (const SweepEvent*) p2;
+
+    if ( e1->point.x != e2->point.x ) {
+        return e1->point.x < e2->point.x ? -1 : 1;
+    }
+    if ( e1->point.y != e2->point.y ) {
+        return e1->point.y < e2->point.y ? -1 : 1;
+    }
+
+    // edges starting at a point are inserted before the ones ending there
+    // are removed, so edges touching there are neighbors at some moment
+    if ( e1->start != e2->start ) {
+        return e1->start ? -1 : 1;
+    }
+
+    return e1->edge - e2->edge;
+
+}
+
+static void rotateUp( SweepStatus *ss, int x ) {
+
+    SweepNode *nodes = ss->nodes;
+    int p = nodes[x].parent;
+    int g = nodes[p].parent;
+
+    if ( nodes[p].left == x ) {
+        int child = nodes[x].right;
+        nodes[p].left = child;
+        if ( child >= 0 ) {
+            nodes[child].parent = p;
+        }
+        nodes[x].right = p;
+    } else {
+        int child = nodes[x].left;
+        nodes[p].right = child;
+        if ( child >= 0 ) {
+            nodes[child].parent = p;
+        }
+        nodes[x].left = p;
+    }
+
+    nodes[p].parent = x;
+    nodes[x].parent = g;
+
+    if ( g < 0 ) {
+        ss->root = x;
+    } else if ( nodes[g].left == p ) {
+        nodes[g].left = x;
+    } else {
+        nodes[g].right = x;
+    }
+
+}
+
+static void insertSweepEdge( SweepStatus *ss, int edge ) {
+
+    SweepNode *nodes = ss->nodes;
+    nodes[edge].left = -1;
+    nodes[edge].right = -1;
+    nodes[edge].parent = -1;
+
+    if ( ss->root < 0 ) {
+        ss->root = edge;
+        return;
+    }
+
+    int current = ss->root;
+    while ( true ) {
+        int *child = compareEdges( ss, edge, current ) < 0 ? &nodes[current].left : &nodes[current].right;
+        if ( *child < 0 ) {
+            *child = edge;
+            nodes[edge].parent = current;
+            break;
+        }
+        current = *child;
+    }
+
+    while ( nodes[edge].parent >= 0 && nodes[nodes[edge].parent].priority < nodes[edge].priority ) {
+        rotateUp( ss, edge );
+    }
+
+}
+
+static void removeSweepEdge( SweepStatus *ss, int edge ) {
+
+    SweepNode *nodes = ss->nodes;
+
+    // rotated down to a leaf, then detached
+    while ( nodes[edge].left >= 0 || nodes[edge].right >= 0 ) {
+        int left = nodes[edge].left;
+        int right = nodes[edge].right;
+        int child = left < 0 ? right : right < 0 ? left : nodes[left].priority > nodes[right].priority ? left : right;
+        rotateUp( ss, child );
+    }
+
+    int p = nodes[edge].parent;
+    if ( p < 0 ) {
+        ss->root = -1;
+    } else if ( nodes[p].left == edge ) {
+        nodes[p].left = -1;
+    } else {
+        nodes[p].right = -1;
+    }
+
+}
+
+static int getSweepNeighbor( const SweepStatus *ss, int edge, bool above ) {
+
+    const SweepNode *nodes = ss->nodes;
+    int child = above ? nodes[edge].right : nodes[edge].left;
+
+    if ( child >= 0 ) {
+        while ( ( above ? nodes[child].left : nodes[child].right ) >= 0 ) {
+            child = above ? nodes[child].left : nodes[child].right;
+        }
+        return child;
+    }
+
+    int current = edge;
+    int p = nodes[current].parent;
+    while ( p >= 0 && ( above ? nodes[p].right : nodes[p].left ) == current ) {
+        current = p;
+        p = nodes[p].parent;
+    }
+
+    return p;
+
+}
+
+static bool checkSweepNeighbors( const SweepStatus *ss, int edgeA, int edgeB, int *edgeOutA, int *edgeOutB, b2Vec2 *intersection ) {
+
+    if ( edgeA < 0 || edgeB < 0 || !intersectEdges( ss, edgeA, edgeB, intersection ) ) {
+        return false;
+    }
+
+    *edgeOutA = edgeA < edgeB ? edgeA : edgeB;
+    *edgeOutB = edgeA < edgeB ? edgeB : edgeA;
+
+    return true;
+
+}
+
+/**
+ * @brief Shamos-Hoey sweep line check of a closed polygon, O(n log n).
+ * Returns true if two of its edges cross, touch or overlap, writing the
+ * indices of the edges, edge i going from vertex i to vertex i + 1, and
+ * a point shared by them. Adjacent edges only intersect when one folds
+ * back over the other. Repeated consecutive vertices must be welded
+ * first. Chain obstacles pass at most MAX_CHAIN_OBSTACLE_POINTS - 1
+ * vertices, where the sweep runs on the stack buffers and is hardly
+ * faster than the pairwise check; it pays off on larger outlines.
+ */
+bool findPolygonSelfIntersection( const b2Vec2 *points, int pointCount, int *edgeA, int *edgeB, b2Vec2 *intersection ) {
+
+    if ( pointCount < 3 ) {
+        return false;
+    }
+
+    SweepEvent eventBuffer[SWEEP_STACK_EDGES*2];
+    SweepNode nodeBuffer[SWEEP_STACK_EDGES];
+    bool heap = pointCount > SWEEP_STACK_EDGES;
+
+    SweepEvent *events = heap ? (SweepEvent*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( SweepEvent ) * pointCount * 2 ) : eventBuffer;
+    SweepNode *nodes = heap ? (SweepNode*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( SweepNode ) * pointCount ) : nodeBuffer;
+
+    SweepStatus ss = { points, pointCount, nodes, -1 };
+
+    // xorshift32 priorities, the same tree on every run
+    uint32_t state = 2463534242u;
+
+    for ( int i = 0; i < pointCount; i++ ) {
+
+        b2Vec2 a, b;
+        getEdge( &ss, i, &a, &b );
+        events[i*2] = (SweepEvent){ a, i, true };
+        events[i*2+1] = (SweepEvent){ b, i, false };
+
+        nodes[i].priority = nextRandom( &state );
+
+    }
+
+    qsort( events, pointCount * 2, sizeof( SweepEvent ), compareSweepEvents );
+
+    bool found = false;
+
+    for ( int i = 0; i < pointCount * 2 && !found; i++ ) {
+
+        int edge = events[i].edge;
+
+        if ( events[i].start ) {
+            insertSweepEdge( &ss, edge );
+            found = checkSweepNeighbors( &ss, edge, getSweepNeighbor( &ss, edge, true ), edgeA, edgeB, intersection ) ||
+                    checkSweepNeighbors( &ss, edge, getSweepNeighbor( &ss, edge, false ), edgeA, edgeB, intersection );
+        } else {
+            int above = getSweepNeighbor( &ss, edge, true );
+            int below = getSweepNeighbor( &ss, edge, false );
+            removeSweepEdge( &ss, edge );
+            found = checkSweepNeighbors( &ss, above, below, edgeA, edgeB, intersection );
+        }
+
+    }
+
+    if ( heap ) {
+        freeMemory( events );
+        freeMemory( nodes );
+    }
+
+    return found;
+
+}
+
+/**
+ * @brief Splits a closed polygon in two at an intersection of edges edgeA
+ * and edgeB, edgeA < edgeB, found by findPolygonSelfIntersection. Both
+ * loops get the intersection point and have less vertices than the
+ * polygon. first and second need room for pointCount vertices.
+ */
+void splitPolygonAtIntersection( const b2Vec2 *points, int pointCount, int edgeA, int edgeB, b2Vec2 intersection,
+                                 b2Vec2 *first, int *firstCount, b2Vec2 *second, int *secondCount ) {
+
+    // 0 .. edgeA, intersection, edgeB + 1 .. n - 1
+    int count = 0;
+    for ( int i = 0; i <= edgeA; i++ ) {
+        first[count++] = points[i];
+    }
+    first[count++] = intersection;
+    for ( int i = edgeB + 1; i < pointCount; i++ ) {
+        first[count++] = points[i];
+    }
+    *firstCount = count;
+
+    // intersection, edgeA + 1 .. edgeB
+    count = 0;
+    second[count++] = intersection;
+    for ( int i = edgeA + 1; i <= edgeB; i++ ) {
+        second[count++] = points[i];
+    }
+    *secondCount = count;
+
+}
+
+static bool isPointInTriangle( b2Vec2 p, b2Vec2 a, b2Vec2 b, b2Vec2 c, float winding ) {
+    return winding * orientation( a, b, p ) >= 0.0f &&
+           winding * orientation( b, c, p ) >= 0.0f &&
+           winding * orientation( c, a, p ) >= 0.0f;
+}
+
+static bool isConvexLoop( const b2Vec2 *points, const int *loop, int count, float winding ) {
+
+    for ( int i = 0; i < count; i++ ) {
+        b2Vec2 a = points[loop[( i + count - 1 ) % count]];
+        b2Vec2 b = points[loop[i]];
+        b2Vec2 c = points[loop[( i + 1 ) % count]];
+        if ( winding * orientation( a, b, c ) < 0.0f ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+static int findPieceRoot( int *parents, int piece ) {
+    while ( parents[piece] != piece ) {
+        parents[piece] = parents[parents[piece]];
+        piece = parents[piece];
+    }
+    return piece;
+}
+
+// index of the edge from -> to in the loop, -1 if it isn't there
+static int findLoopEdge( const int *loop, int count, int from, int to ) {
+    for ( int i = 0; i < count; i++ ) {
+        if ( loop[i] == from && loop[( i + 1 ) % count] == to ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Hertel-Mehlhorn decomposition of a simple polygon into convex
+ * pieces of at most B2_MAX_POLYGON_VERTICES vertices: ear clipping, then
+ * the diagonals whose removal keeps both sides convex are removed.
+ * Returns the quantity of pieces written, at most four times the optimum,
+ * or 0 if the polygon can't be decomposed into maxPieces pieces.
+ */
+int decomposeConvexPolygon( const b2Vec2 *points, int pointCount, ConvexPiece *pieces, int maxPieces ) {
+
+    if ( pointCount < 3 || pointCount > CONVEX_DECOMPOSITION_MAX_VERTICES ) {
+        return 0;
+    }
+
+    float winding = computePolygonSignedArea( points, pointCount ) < 0.0f ? -1.0f : 1.0f;
+
+    // every triangle starts as a piece, merged pieces live in the loop
+    // of their root
+    int loops[CONVEX_DECOMPOSITION_MAX_VERTICES][B2_MAX_POLYGON_VERTICES];
+    int loopCounts[CONVEX_DECOMPOSITION_MAX_VERTICES];
+    int parents[CONVEX_DECOMPOSITION_MAX_VERTICES];
+    int diagonals[CONVEX_DECOMPOSITION_MAX_VERTICES][3];
+    int remaining[CONVEX_DECOMPOSITION_MAX_VERTICES];
+    int triangleQuantity = 0;
+    int diagonalQuantity = 0;
+    int n = pointCount;
+
+    for ( int i = 0; i < n; i++ ) {
+        remaining[i] = i;
+    }
+
+    while ( n >= 3 ) {
+
+        int ear = -1;
+
+        for ( int i = 0; i < n && ear < 0; i++ ) {
+
+            int p = remaining[( i + n - 1 ) % n];
+            int c = remaining[i];
+            int q = remaining[( i + 1 ) % n];
+
+            if ( winding * orientation( points[p], points[c], points[q] ) <= 0.0f ) {
+                continue;
+            }
+
+            bool inside = false;
+            for ( int j = 0; j < n && !inside; j++ ) {
+                int v = remaining[j];
+                if ( v != p && v != c && v != q ) {
+                    inside = isPointInTriangle( points[v], points[p], points[c], points[q], winding );
+                }
+            }
+
+            if ( !inside ) {
+                ear = i;
+            }
+
+        }
+
+        if ( ear < 0 ) {
+            return 0;
+        }
+
+        int p = remaining[( ear + n - 1 ) % n];
+        int q = remaining[( ear + 1 ) % n];
+
+        loops[triangleQuantity][0] = p;
+        loops[triangleQuantity][1] = remaining[ear];
+        loops[triangleQuantity][2] = q;
+        loopCounts[triangleQuantity] = 3;
+        parents[triangleQuantity] = triangleQuantity;
+
+        // the edge q -> p of the ear is a diagonal, shared with a later
+        // triangle
+        if ( n > 3 ) {
+            diagonals[diagonalQuantity][0] = p;
+            diagonals[diagonalQuantity][1] = q;
+            diagonals[diagonalQuantity][2] = triangleQuantity;
+            diagonalQuantity++;
+        }
+
+        triangleQuantity++;
+
+        for ( int i = ear; i < n - 1; i++ ) {
+            remaining[i] = remaining[i+1];
+        }
+        n--;
+
+    }
+
+    for ( int d = 0; d < diagonalQuantity; d++ ) {
+
+        int u = diagonals[d][0];
+        int v = diagonals[d][1];
+
+        // the ear has p -> c -> q, so q -> p, and the other side p -> q
+        int a = findPieceRoot( parents, diagonals[d][2] );
+        int b = -1;
+        for ( int t = diagonals[d][2] + 1; t < triangleQuantity && b < 0; t++ ) {
+            int root = findPieceRoot( parents, t );
+            if ( root != a && findLoopEdge( loops[root], loopCounts[root], u, v ) >= 0 ) {
+                b = root;
+            }
+        }
+
+        if ( b < 0 || loopCounts[a] + loopCounts[b] - 2 > B2_MAX_POLYGON_VERTICES ) {
+            continue;
+        }
+
+        // a from p around to q, then b from q around to p, without the
+        // shared vertices
+        int merged[B2_MAX_POLYGON_VERTICES*2];
+        int count = 0;
+        int ia = findLoopEdge( loops[a], loopCounts[a], v, u );
+        int ib = findLoopEdge( loops[b], loopCounts[b], u, v );
+
+        if ( ia < 0 || ib < 0 ) {
+            continue;
+        }
+
+        for ( int i = 1; i <= loopCounts[a]; i++ ) {
+            merged[count++] = loops[a][( ia + i ) % loopCounts[a]];
+        }
+        for ( int i = 2; i < loopCounts[b]; i++ ) {
+            merged[count++] = loops[b][( ib + i ) % loopCounts[b]];
+        }
+
+        if ( isConvexLoop( points, merged, count, winding ) ) {
+            for ( int i = 0; i < count; i++ ) {
+                loops[a][i] = merged[i];
+            }
+            loopCounts[a] = count;
+            parents[b] = a;
+        }
+
+    }
+
+    int pieceQuantity = 0;
+
+    for ( int t = 0; t < triangleQuantity; t++ ) {
+
+        if ( parents[t] != t ) {
+            continue;
+        }
+
+        if ( pieceQuantity >= maxPieces ) {
+            return 0;
+        }
+
+        ConvexPiece *piece = &pieces[pieceQuantity++];
+        piece->pointCount = loopCounts[t];
+        for ( int i = 0; i < loopCounts[t]; i++ ) {
+            piece->points[i] = points[loops[t][i]];
+        }
+
+    }
+
+    return pieceQuantity;
+
+}
+
+// crossings closer than this to a vertex, in edge parameters, are
+// treated as degenerate and resolved by nudging the clip polygon
+#define SUBTRACTION_EPSILON 1e-4f
+#define SUBTRACTION_ATTEMPTS 4
+
+typedef struct ClipIntersection {
+    b2Vec2 point;
+    int subjectEdge;
+    int clipEdge;
+    float subjectAlpha;
+    float clipAlpha;
+} ClipIntersection;
+
+/**
+ * @brief Vertex or intersection of one of the polygons of a subtraction.
+ * Intersections know the node of the same point in the other polygon.
+ */
+typedef struct ClipNode {
+    b2Vec2 point;
+    int intersection;
+    int neighbor;
+    bool entering;
+    bool visited;
+} ClipNode;
+
+static bool isPointInPolygon( b2Vec2 p, const b2Vec2 *points, int pointCount ) {
+
+    bool inside = false;
+
+    for ( int i = 0, j = pointCount - 1; i < pointCount; j = i++ ) {
+        b2Vec2 a = points[i];
+        b2Vec2 b = points[j];
+        if ( ( a.y > p.y ) != ( b.y > p.y ) && p.x < a.x + ( b.x - a.x ) * ( p.y - a.y ) / ( b.y - a.y ) ) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+
+}
+
+/**
+ * @brief Finds the crossings of every subject edge with every clip edge.
+ * Returns the quantity found, -1 if one of them touches a vertex or
+ * overlaps an edge and -2 if there are too many.
+ */
+static int findClipIntersections( const b2Vec2 *subject, int subjectCount, const b2Vec2 *clip, int clipCount, ClipIntersection *intersections ) {
+
+    int quantity = 0;
+
+    for ( int i = 0; i < subjectCount; i++ ) {
+
+        b2Vec2 p = subject[i];
+        b2Vec2 r = b2Sub( subject[( i + 1 ) % subjectCount], p );
+
+        for ( int j = 0; j < clipCount; j++ ) {
+
+            b2Vec2 q = clip[j];
+            b2Vec2 s = b2Sub( clip[( j + 1 ) % clipCount], q );
+            b2Vec2 pq = b2Sub( q, p );
+            float d = b2Cross( r, s );
+
+            if ( fabsf( d ) <= SUBTRACTION_EPSILON * b2Length( r ) * b2Length( s ) ) {
+                // parallel, only a problem when they overlap
+                if ( fabsf( b2Cross( pq, r ) ) <= SUBTRACTION_EPSILON * b2LengthSquared( r ) ) {
+                    float t0 = b2Dot( pq, r ) / b2LengthSquared( r );
+                    float t1 = t0 + b2Dot( s, r ) / b2LengthSquared( r );
+                    if ( fmaxf( t0, t1 ) >= -SUBTRACTION_EPSILON && fminf( t0, t1 ) <= 1.0f + SUBTRACTION_EPSILON ) {
+                        return -1;
+                    }
+                }
+                continue;
+            }
+
+            float t = b2Cross( pq, s ) / d;
+            float u = b2Cross( pq, r ) / d;
+
+            if ( t < -SUBTRACTION_EPSILON || t > 1.0f + SUBTRACTION_EPSILON ||
+                 u < -SUBTRACTION_EPSILON || u > 1.0f + SUBTRACTION_EPSILON ) {
+                continue;
+            }
+
+            if ( t < SUBTRACTION_EPSILON || t > 1.0f - SUBTRACTION_EPSILON ||
+                 u < SUBTRACTION_EPSILON || u > 1.0f - SUBTRACTION_EPSILON ) {
+                return -1;
+            }
+
+            if ( quantity == POLYGON_SUBTRACTION_MAX_INTERSECTIONS ) {
+                return -2;
+            }
+
+            intersections[quantity++] = (ClipIntersection){ b2MulAdd( p, t, r ), i, j, t, u };
+
+        }
+
+    }
+
+    return quantity;
+
+}
+
+/**
+ * @brief Builds the node list of a polygon: its vertices with the
+ * intersections of each edge after them, in edge order. Returns the
+ * quantity of nodes and fills the node of each intersection.
+ */
+static int buildClipNodes( const b2Vec2 *points, int pointCount, const ClipIntersection *intersections, int intersectionCount,
+                           bool subject, ClipNode *nodes, int *intersectionNodes ) {
+
+    int quantity = 0;
+
+    for ( int i = 0; i < pointCount; i++ ) {
+
+        nodes[quantity++] = (ClipNode){ points[i], -1, -1, false, false };
+        int first = quantity;
+
+        for ( int k = 0; k < intersectionCount; k++ ) {
+
+            const ClipIntersection *x = &intersections[k];
+            if ( ( subject ? x->subjectEdge : x->clipEdge ) != i ) {
+                continue;
+            }
+
+            // insertion by the parameter along the edge
+            float alpha = subject ? x->subjectAlpha : x->clipAlpha;
+            int at = quantity;
+            while ( at > first ) {
+                const ClipIntersection *o = &intersections[nodes[at - 1].intersection];
+                if ( ( subject ? o->subjectAlpha : o->clipAlpha ) <= alpha ) {
+                    break;
+                }
+                nodes[at] = nodes[at - 1];
+                at--;
+            }
+
+            nodes[at] = (ClipNode){ x->point, k, -1, false, false };
+            quantity++;
+
+        }
+
+    }
+
+    for ( int i = 0; i < quantity; i++ ) {
+        if ( nodes[i].intersection >= 0 ) {
+            intersectionNodes[nodes[i].intersection] = i;
+        }
+    }
+
+    return quantity;
+
+}
+
+/**
+ * @brief Greiner-Hormann subtraction of the simple polygon clip from the
+ * simple polygon subject. When the outlines cross, the remaining pieces
+ * are written one after the other into result, their vertex quantities
+ * into resultCounts and their quantity into *resultQuantity, with the
+ * winding of subject, and CLIPPED is returned. Otherwise subject is
+ * either untouched (DISJOINT), covered (REMOVED) or would get a hole
+ * (HOLE). Vertices lying on the other outline are resolved by nudging
+ * clip a little. FAILED means the limits or the capacities were exceeded.
+ */
+PolygonSubtraction subtractPolygon( const b2Vec2 *subject, int subjectCount, const b2Vec2 *clip, int clipCount,
+                                    b2Vec2 *result, int resultCapacity, int *resultCounts, int maxResults, int *resultQuantity ) {
+
+    *resultQuantity = 0;
+
+    if ( subjectCount < 3 || clipCount < 3 ||
+         subjectCount > POLYGON_SUBTRACTION_MAX_VERTICES || clipCount > POLYGON_SUBTRACTION_MAX_VERTICES ) {
+        return POLYGON_SUBTRACTION_FAILED;
+    }
+
+    // the clip walked backwards keeps the winding only if both agree
+    b2Vec2 nudged[POLYGON_SUBTRACTION_MAX_VERTICES];
+    bool reversed = ( computePolygonSignedArea( subject, subjectCount ) > 0.0f ) !=
+                    ( computePolygonSignedArea( clip, clipCount ) > 0.0f );
+
+    ClipIntersection intersections[POLYGON_SUBTRACTION_MAX_INTERSECTIONS];
+    int intersectionCount = -1;
+
+    for ( int attempt = 0; attempt < SUBTRACTION_ATTEMPTS && intersectionCount == -1; attempt++ ) {
+
+        // a tiny offset, far below the cleanup tolerances, turning at
+        // each attempt in case it runs along the edge of a bad crossing
+        b2Vec2 offset = { 0.015f * attempt * cosf( 2.1f * attempt ), 0.015f * attempt * sinf( 2.1f * attempt ) };
+        for ( int i = 0; i < clipCount; i++ ) {
+            nudged[i] = b2Add( clip[reversed ? clipCount - 1 - i : i], offset );
+        }
+
+        intersectionCount = findClipIntersections( subject, subjectCount, nudged, clipCount, intersections );
+
+    }
+
+    if ( intersectionCount < 0 ) {
+        return POLYGON_SUBTRACTION_FAILED;
+    }
+
+    if ( intersectionCount == 0 ) {
+        if ( isPointInPolygon( subject[0], nudged, clipCount ) ) {
+            return POLYGON_SUBTRACTION_REMOVED;
+        }
+        if ( isPointInPolygon( nudged[0], subject, subjectCount ) ) {
+            return POLYGON_SUBTRACTION_HOLE;
+        }
+        return POLYGON_SUBTRACTION_DISJOINT;
+    }
+
+    ClipNode subjectNodes[POLYGON_SUBTRACTION_MAX_VERTICES + POLYGON_SUBTRACTION_MAX_INTERSECTIONS];
+    ClipNode clipNodes[POLYGON_SUBTRACTION_MAX_VERTICES + POLYGON_SUBTRACTION_MAX_INTERSECTIONS];
+    int subjectIntersectionNodes[POLYGON_SUBTRACTION_MAX_INTERSECTIONS];
+    int clipIntersectionNodes[POLYGON_SUBTRACTION_MAX_INTERSECTIONS];
+
+    int subjectNodeCount = buildClipNodes( subject, subjectCount, intersections, intersectionCount, true, subjectNodes, subjectIntersectionNodes );
+    int clipNodeCount = buildClipNodes( nudged, clipCount, intersections, intersectionCount, false, clipNodes, clipIntersectionNodes );
+
+    for ( int k = 0; k < intersectionCount; k++ ) {
+        subjectNodes[subjectIntersectionNodes[k]].neighbor = clipIntersectionNodes[k];
+        clipNodes[clipIntersectionNodes[k]].neighbor = subjectIntersectionNodes[k];
+    }
+
+    // an intersection enters the clip if the subject goes inside it
+    // right after, which is decided halfway to the next node
+    for ( int i = 0; i < subjectNodeCount; i++ ) {
+        if ( subjectNodes[i].intersection >= 0 ) {
+            b2Vec2 next = subjectNodes[( i + 1 ) % subjectNodeCount].point;
+            subjectNodes[i].entering = isPointInPolygon( b2Lerp( subjectNodes[i].point, next, 0.5f ), nudged, clipCount );
+        }
+    }
+
+    // each piece goes along the subject outside the clip, from where it
+    // leaves the clip to where it enters it again, then back along the
+    // clip inside the subject, to where the subject leaves it again
+    int used = 0;
+    int steps = 0;
+    int maxSteps = 2 * ( subjectNodeCount + clipNodeCount );
+
+    for ( int start = 0; start < subjectNodeCount; start++ ) {
+
+        ClipNode *first = &subjectNodes[start];
+        if ( first->intersection < 0 || first->entering || first->visited ) {
+            continue;
+        }
+
+        if ( *resultQuantity == maxResults ) {
+            return POLYGON_SUBTRACTION_FAILED;
+        }
+
+        int count = 0;
+        int current = start;
+
+        do {
+
+            ClipNode *exit = &subjectNodes[current];
+            if ( exit->entering || exit->visited ) {
+                return POLYGON_SUBTRACTION_FAILED;
+            }
+            exit->visited = true;
+            clipNodes[exit->neighbor].visited = true;
+
+            int s = current;
+            do {
+                if ( used + count == resultCapacity || ++steps > maxSteps ) {
+                    return POLYGON_SUBTRACTION_FAILED;
+                }
+                result[used + count++] = subjectNodes[s].point;
+                s = ( s + 1 ) % subjectNodeCount;
+            } while ( subjectNodes[s].intersection < 0 );
+
+            ClipNode *entry = &subjectNodes[s];
+            if ( !entry->entering || entry->visited ) {
+                return POLYGON_SUBTRACTION_FAILED;
+            }
+            entry->visited = true;
+            clipNodes[entry->neighbor].visited = true;
+
+            int c = entry->neighbor;
+            do {
+                if ( used + count == resultCapacity || ++steps > maxSteps ) {
+                    return POLYGON_SUBTRACTION_FAILED;
+                }
+                result[used + count++] = clipNodes[c].point;
+                c = ( c + clipNodeCount - 1 ) % clipNodeCount;
+            } while ( clipNodes[c].intersection < 0 );
+
+            current = clipNodes[c].neighbor;
+
+        } while ( current != start );
+
+        resultCounts[( *resultQuantity )++] = count;
+        used += count;
+
+    }
+
+    return *resultQuantity > 0 ? POLYGON_SUBTRACTION_CLIPPED : POLYGON_SUBTRACTION_FAILED;
+
+}
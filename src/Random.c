@@ -0,0 +1,47 @@
+/**
+ * @file Random.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Deterministic random number implementation.
+ *
+ * xorshift32, the same sequence on every platform, unlike rand(), so the
+ * generated scenes, tile maps and sounds are the same on every run.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdint.h>
+
+#include "Random.h"
+
+/**
+ * @brief Advances a xorshift32 state and returns it. The state must not
+ * be zero.
+ */
+uint32_t nextRandom( uint32_t *state ) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Returns a float in [0, 1) from the high 24 bits of the next value.
+ */
+float nextRandomFloat( uint32_t *state ) {
+    return ( nextRandom( state ) >> 8 ) * ( 1.0f / 16777216.0f );
+}
+
+/**
+ * @brief Returns a float in [min, max].
+ */
+float randomRange( uint32_t *state, float min, float max ) {
+    return min + ( max - min ) * ( nextRandom( state ) / 4294967295.0f );
+}
+
+/**
+ * @brief Returns an int in [min, max].
+ */
+int randomInt( uint32_t *state, int min, int max ) {
+    return min + (int) ( nextRandom( state ) % (uint32_t) ( max - min + 1 ) );
+}
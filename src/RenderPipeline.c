@@ -0,0 +1,171 @@
+/**
+ * @file RenderPipeline.c
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderPipeline implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "RenderPipeline.h"
+#include "Memory.h"
+#include "GameWorld.h"
+#include "GameInput.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+
+static void *runSimulation( void *data ) {
+
+    RenderPipeline *rp = (RenderPipeline*) data;
+
+    while ( true ) {
+
+        pthread_mutex_lock( &rp->mutex );
+        while ( rp->running && !rp->stepRequested ) {
+            pthread_cond_wait( &rp->stepCondition, &rp->mutex );
+        }
+        if ( !rp->running ) {
+            pthread_mutex_unlock( &rp->mutex );
+            break;
+        }
+        GameInput input = rp->pendingInput;
+        // the frames submitted during a long step are stepped at once,
+        // the time beyond the limit is dropped to keep the step stable
+        float delta = rp->pendingDelta < RENDER_PIPELINE_MAX_DELTA ? rp->pendingDelta : RENDER_PIPELINE_MAX_DELTA;
+        rp->pendingInput = (GameInput) { 0 };
+        rp->pendingDelta = 0.0f;
+        rp->stepRequested = false;
+        pthread_mutex_unlock( &rp->mutex );
+
+        double start = GetTime();
+        updateGameWorld( rp->gw, &input, delta );
+
+        RenderSnapshot *rs = rp->snapshots[rp->writeIndex];
+        captureRenderSnapshot( rp->gw, rs );
+        rs->pipelined = true;
+        rs->updateTime = ( GetTime() - start ) * 1000.0;
+
+        pthread_mutex_lock( &rp->mutex );
+        int ready = rp->readyIndex;
+        rp->readyIndex = rp->writeIndex;
+        rp->writeIndex = ready;
+        rp->readyIsNew = true;
+        pthread_mutex_unlock( &rp->mutex );
+
+    }
+
+    return NULL;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated RenderPipeline struct instance
+ * and starts its simulation thread. From now on the GameWorld must only
+ * be touched by the pipeline. Returns NULL if the thread can't be
+ * started.
+ */
+RenderPipeline* createRenderPipeline( GameWorld *gw ) {
+
+    RenderPipeline *rp = (RenderPipeline*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( RenderPipeline ) );
+
+    rp->gw = gw;
+
+    for ( int i = 0; i < 3; i++ ) {
+        rp->snapshots[i] = (RenderSnapshot*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( RenderSnapshot ) );
+        rp->snapshots[i]->capturedTick = -1;
+        rp->snapshots[i]->obstaclesQuantity = 0;
+        rp->snapshots[i]->chainObstacleQuantity = 0;
+    }
+    rp->writeIndex = 0;
+    rp->readyIndex = 1;
+    rp->readIndex = 2;
+    rp->readyIsNew = false;
+
+    // the first frame is drawn from the current state
+    captureRenderSnapshot( gw, rp->snapshots[rp->readIndex] );
+    rp->snapshots[rp->readIndex]->pipelined = true;
+    rp->snapshots[rp->readIndex]->updateTime = 0.0;
+
+    rp->pendingInput = (GameInput) { 0 };
+    rp->pendingDelta = 0.0f;
+    rp->stepRequested = false;
+    rp->running = true;
+
+    pthread_mutex_init( &rp->mutex, NULL );
+    pthread_cond_init( &rp->stepCondition, NULL );
+
+    if ( pthread_create( &rp->thread, NULL, runSimulation, rp ) != 0 ) {
+        TraceLog( LOG_WARNING, "PIPELINE: could not start the simulation thread" );
+        pthread_cond_destroy( &rp->stepCondition );
+        pthread_mutex_destroy( &rp->mutex );
+        for ( int i = 0; i < 3; i++ ) {
+            freeMemory( rp->snapshots[i] );
+        }
+        freeMemory( rp );
+        return NULL;
+    }
+
+    return rp;
+
+}
+
+/**
+ * @brief Stops the simulation thread and destroys the RenderPipeline.
+ * The GameWorld is not destroyed.
+ */
+void destroyRenderPipeline( RenderPipeline *rp ) {
+
+    pthread_mutex_lock( &rp->mutex );
+    rp->running = false;
+    pthread_cond_signal( &rp->stepCondition );
+    pthread_mutex_unlock( &rp->mutex );
+
+    pthread_join( rp->thread, NULL );
+    pthread_cond_destroy( &rp->stepCondition );
+    pthread_mutex_destroy( &rp->mutex );
+
+    for ( int i = 0; i < 3; i++ ) {
+        freeMemory( rp->snapshots[i] );
+    }
+
+    freeMemory( rp );
+
+}
+
+/**
+ * @brief Hands the input of the current frame to the simulation thread.
+ * If the previous step is still running, input and delta are accumulated
+ * for the next one.
+ */
+void submitRenderPipelineInput( RenderPipeline *rp, const GameInput *input, float delta ) {
+
+    pthread_mutex_lock( &rp->mutex );
+    mergeGameInput( &rp->pendingInput, input );
+    rp->pendingDelta += delta;
+    rp->stepRequested = true;
+    pthread_cond_signal( &rp->stepCondition );
+    pthread_mutex_unlock( &rp->mutex );
+
+}
+
+/**
+ * @brief Returns the latest published snapshot. It stays valid until the
+ * next call.
+ */
+RenderSnapshot* acquireRenderPipelineSnapshot( RenderPipeline *rp ) {
+
+    pthread_mutex_lock( &rp->mutex );
+    if ( rp->readyIsNew ) {
+        int ready = rp->readyIndex;
+        rp->readyIndex = rp->readIndex;
+        rp->readIndex = ready;
+        rp->readyIsNew = false;
+    }
+    pthread_mutex_unlock( &rp->mutex );
+
+    return rp->snapshots[rp->readIndex];
+
+}
@@ -0,0 +1,259 @@
+/**
+ * @file RenderScaler.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Internal resolution scaler implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "RenderScaler.h"
+#include "Memory.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+// sharp bilinear: each source texel is a flat square and only the
+// prescale wide border between two texels is interpolated, so upscaled
+// edges stay crisp without the uneven pixels of nearest filtering
+static const char *upscaleFragmentShaderCode =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "uniform vec2 textureSize;\n"
+    "uniform float prescale;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    vec2 texel = fragTexCoord * textureSize;\n"
+    "    vec2 centerDistance = fract( texel ) - 0.5;\n"
+    "    float regionRange = 0.5 - 0.5 / prescale;\n"
+    "    vec2 f = ( centerDistance - clamp( centerDistance, -regionRange, regionRange ) ) * prescale + 0.5;\n"
+    "    vec2 uv = ( floor( texel ) + f ) / textureSize;\n"
+    "    finalColor = texture( texture0, uv ) * colDiffuse * fragColor;\n"
+    "}\n";
+
+// FXAA 3.11 "lite": blurs along the edge direction found from the luma
+// of the diagonal neighbors, rejecting the wider blur when it overshoots
+// the local luma range
+static const char *fxaaFragmentShaderCode =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "uniform vec2 textureSize;\n"
+    "out vec4 finalColor;\n"
+    "const vec3 lumaWeights = vec3( 0.299, 0.587, 0.114 );\n"
+    "const float reduceMin = 1.0 / 128.0;\n"
+    "const float reduceMul = 1.0 / 8.0;\n"
+    "const float spanMax = 8.0;\n"
+    "void main() {\n"
+    "    vec2 texel = 1.0 / textureSize;\n"
+    "    vec2 uv = fragTexCoord;\n"
+    "    float lumaNW = dot( texture( texture0, uv + vec2( -1.0, -1.0 ) * texel ).rgb, lumaWeights );\n"
+    "    float lumaNE = dot( texture( texture0, uv + vec2( 1.0, -1.0 ) * texel ).rgb, lumaWeights );\n"
+    "    float lumaSW = dot( texture( texture0, uv + vec2( -1.0, 1.0 ) * texel ).rgb, lumaWeights );\n"
+    "    float lumaSE = dot( texture( texture0, uv + vec2( 1.0, 1.0 ) * texel ).rgb, lumaWeights );\n"
+    "    vec4 center = texture( texture0, uv );\n"
+    "    float lumaM = dot( center.rgb, lumaWeights );\n"
+    "    float lumaMin = min( lumaM, min( min( lumaNW, lumaNE ), min( lumaSW, lumaSE ) ) );\n"
+    "    float lumaMax = max( lumaM, max( max( lumaNW, lumaNE ), max( lumaSW, lumaSE ) ) );\n"
+    "    vec2 dir = vec2( -( ( lumaNW + lumaNE ) - ( lumaSW + lumaSE ) ), ( lumaNW + lumaSW ) - ( lumaNE + lumaSE ) );\n"
+    "    float dirReduce = max( ( lumaNW + lumaNE + lumaSW + lumaSE ) * 0.25 * reduceMul, reduceMin );\n"
+    "    float rcpDirMin = 1.0 / ( min( abs( dir.x ), abs( dir.y ) ) + dirReduce );\n"
+    "    dir = clamp( dir * rcpDirMin, vec2( -spanMax ), vec2( spanMax ) ) * texel;\n"
+    "    vec3 rgbA = 0.5 * ( texture( texture0, uv + dir * ( 1.0 / 3.0 - 0.5 ) ).rgb +\n"
+    "                        texture( texture0, uv + dir * ( 2.0 / 3.0 - 0.5 ) ).rgb );\n"
+    "    vec3 rgbB = rgbA * 0.5 + 0.25 * ( texture( texture0, uv - dir * 0.5 ).rgb +\n"
+    "                                      texture( texture0, uv + dir * 0.5 ).rgb );\n"
+    "    float lumaB = dot( rgbB, lumaWeights );\n"
+    "    vec3 rgb = lumaB < lumaMin || lumaB > lumaMax ? rgbA : rgbB;\n"
+    "    finalColor = vec4( rgb, center.a ) * colDiffuse * fragColor;\n"
+    "}\n";
+
+static void ensureTarget( RenderScaler *rsc ) {
+
+    if ( rsc->target.id != 0 &&
+         rsc->target.texture.width == GetScreenWidth() &&
+         rsc->target.texture.height == GetScreenHeight() ) {
+        return;
+    }
+
+    if ( rsc->target.id != 0 ) {
+        UnloadRenderTexture( rsc->target );
+    }
+
+    // full size, the scene uses only its scaled top left region, so
+    // changing the scale doesn't reallocate it. It is not multisampled:
+    // raylib render textures have a single sample, so MSAA is lost when
+    // the scene is drawn here (the renderer reports it as none)
+    rsc->target = LoadRenderTexture( GetScreenWidth(), GetScreenHeight() );
+    SetTextureFilter( rsc->target.texture, TEXTURE_FILTER_BILINEAR );
+
+}
+
+// size of the region of the target that receives the scene
+static int getScaledSize( int size, float scale ) {
+    return (int) roundf( size * scale );
+}
+
+/**
+ * @brief Creates a dinamically allocated RenderScaler struct instance.
+ * Needs an OpenGL context.
+ */
+RenderScaler* createRenderScaler( float scale, bool dynamic, int targetFPS ) {
+
+    RenderScaler *rsc = (RenderScaler*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( RenderScaler ) );
+
+    rsc->target = (RenderTexture2D) { 0 };
+    rsc->upscaleShader = LoadShaderFromMemory( NULL, upscaleFragmentShaderCode );
+    rsc->textureSizeLoc = GetShaderLocation( rsc->upscaleShader, "textureSize" );
+    rsc->prescaleLoc = GetShaderLocation( rsc->upscaleShader, "prescale" );
+
+    rsc->fxaa = false;
+    rsc->fxaaShader = LoadShaderFromMemory( NULL, fxaaFragmentShaderCode );
+    rsc->fxaaTextureSizeLoc = GetShaderLocation( rsc->fxaaShader, "textureSize" );
+
+    rsc->dynamic = dynamic;
+    rsc->active = false;
+    rsc->frameBudget = 1.0f / ( targetFPS > 0 ? targetFPS : 60 );
+    rsc->overBudgetFrames = 0;
+    rsc->withinBudgetFrames = 0;
+
+    setRenderScale( rsc, scale );
+
+    return rsc;
+
+}
+
+/**
+ * @brief Destroys a RenderScaler object and its GPU resources.
+ */
+void destroyRenderScaler( RenderScaler *rsc ) {
+    if ( rsc->target.id != 0 ) {
+        UnloadRenderTexture( rsc->target );
+    }
+    UnloadShader( rsc->upscaleShader );
+    UnloadShader( rsc->fxaaShader );
+    freeMemory( rsc );
+}
+
+/**
+ * @brief Sets the internal resolution scale, clamped to
+ * [RENDER_SCALE_MIN, RENDER_SCALE_MAX].
+ */
+void setRenderScale( RenderScaler *rsc, float scale ) {
+    rsc->scale = fminf( fmaxf( scale, RENDER_SCALE_MIN ), RENDER_SCALE_MAX );
+}
+
+/**
+ * @brief Feeds the last frame time, in seconds, to the dynamic
+ * resolution controller.
+ */
+void updateRenderScale( RenderScaler *rsc, float frameTime ) {
+
+    if ( !rsc->dynamic ) {
+        return;
+    }
+
+    // with a target FPS the frame time never goes below the budget, so
+    // the scale drops quickly when frames are missed and only recovers
+    // after a long run of frames within the budget
+    if ( frameTime > rsc->frameBudget * 1.1f ) {
+        rsc->overBudgetFrames++;
+        rsc->withinBudgetFrames = 0;
+    } else {
+        rsc->withinBudgetFrames++;
+        rsc->overBudgetFrames = 0;
+    }
+
+    if ( rsc->overBudgetFrames >= 15 ) {
+        setRenderScale( rsc, rsc->scale - RENDER_SCALE_STEP );
+        rsc->overBudgetFrames = 0;
+    } else if ( rsc->withinBudgetFrames >= 120 ) {
+        setRenderScale( rsc, rsc->scale + RENDER_SCALE_STEP );
+        rsc->withinBudgetFrames = 0;
+    }
+
+}
+
+/**
+ * @brief Starts drawing the scene, clearing it with color. Below full
+ * scale or with fxaa the scene goes to the offscreen target, so it must be called
+ * between BeginDrawing and EndDrawing, outside of any other texture mode.
+ */
+void beginScaledScene( RenderScaler *rsc, Color color ) {
+
+    rsc->active = rsc->scale < RENDER_SCALE_MAX || rsc->fxaa;
+
+    if ( !rsc->active ) {
+        ClearBackground( color );
+        return;
+    }
+
+    ensureTarget( rsc );
+
+    BeginTextureMode( rsc->target );
+    ClearBackground( color );
+
+    // the projection still covers the whole window, only the viewport
+    // shrinks, so the custom draws that build their MVP from the
+    // modelview and projection matrices are scaled too. In GL
+    // coordinates the top of the scene is the top of the texture
+    int height = rsc->target.texture.height;
+    int scaledHeight = getScaledSize( height, rsc->scale );
+    rlViewport( 0, height - scaledHeight, getScaledSize( rsc->target.texture.width, rsc->scale ), scaledHeight );
+
+}
+
+/**
+ * @brief Finishes the scene started by beginScaledScene, upscaling it to
+ * the window when needed.
+ */
+void endScaledScene( RenderScaler *rsc ) {
+
+    if ( !rsc->active ) {
+        return;
+    }
+
+    // flushes the batch with the scaled viewport still set
+    EndTextureMode();
+
+    float width = rsc->target.texture.width;
+    float height = rsc->target.texture.height;
+    float scaledWidth = getScaledSize( rsc->target.texture.width, rsc->scale );
+    float scaledHeight = getScaledSize( rsc->target.texture.height, rsc->scale );
+    float textureSize[2] = { width, height };
+    float prescale = 1.0f / rsc->scale;
+
+    // with fxaa the edges are smoothed at the internal resolution and
+    // the bilinear filter does the upscaling
+    Shader shader = rsc->upscaleShader;
+    if ( rsc->fxaa ) {
+        shader = rsc->fxaaShader;
+        SetShaderValue( shader, rsc->fxaaTextureSizeLoc, textureSize, SHADER_UNIFORM_VEC2 );
+    } else {
+        SetShaderValue( shader, rsc->textureSizeLoc, textureSize, SHADER_UNIFORM_VEC2 );
+        SetShaderValue( shader, rsc->prescaleLoc, &prescale, SHADER_UNIFORM_FLOAT );
+    }
+
+    // render textures are stored upside down, the scene is in the top
+    // rows of the image, that is, the last rows of the texture
+    BeginShaderMode( shader );
+    DrawTexturePro(
+        rsc->target.texture,
+        (Rectangle){ 0, height - scaledHeight, scaledWidth, -scaledHeight },
+        (Rectangle){ 0, 0, GetScreenWidth(), GetScreenHeight() },
+        (Vector2){ 0, 0 },
+        0.0f,
+        WHITE
+    );
+    EndShaderMode();
+
+    rsc->active = false;
+
+}
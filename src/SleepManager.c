@@ -0,0 +1,133 @@
+/**
+ * @file SleepManager.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Sleep management implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "SleepManager.h"
+#include "Obstacle.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+static bool wakeBodyCallback( b2ShapeId shapeId, void *context ) {
+
+    int *wakes = (int*) context;
+    b2BodyId bodyId = b2Shape_GetBody( shapeId );
+
+    if ( b2Body_GetType( bodyId ) == b2_dynamicBody &&
+         b2Body_IsEnabled( bodyId ) &&
+         !b2Body_IsAwake( bodyId ) ) {
+        b2Body_SetAwake( bodyId, true );
+        (*wakes)++;
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Initializes the sleep settings. Must be called before the
+ * bodies are created, since they read their thresholds from it.
+ */
+void initSleepManager( SleepManager *sm, Rectangle activeRegion, float wakeRadius, int budget ) {
+
+    float lengthUnitsPerMeter = b2GetLengthUnitsPerMeter();
+
+    sm->enableSleep = true;
+    sm->playerSleepThreshold = 0.05f * lengthUnitsPerMeter;
+    sm->dynamicObstacleSleepThreshold = 0.2f * lengthUnitsPerMeter;
+
+    sm->activeRegion = activeRegion;
+    sm->wakeRadius = wakeRadius;
+
+    sm->budget = budget;
+    sm->cursor = 0;
+
+    sm->forcedSleeps = 0;
+    sm->proximityWakes = 0;
+    sm->awakeBodies = 0;
+    sm->sleepingBodies = 0;
+    sm->islands = 0;
+
+}
+
+/**
+ * @brief Forces slow bodies outside the active region to sleep and wakes
+ * sleeping bodies near the focus.
+ */
+void updateSleepManager( SleepManager *sm, GameWorld *gw, b2Vec2 focus ) {
+
+    sm->forcedSleeps = 0;
+    sm->proximityWakes = 0;
+
+    if ( sm->enableSleep ) {
+
+        int evaluations = sm->budget < gw->obstaclesQuantity ? sm->budget : gw->obstaclesQuantity;
+
+        for ( int i = 0; i < evaluations; i++ ) {
+
+            if ( sm->cursor >= gw->obstaclesQuantity ) {
+                sm->cursor = 0;
+            }
+
+            Obstacle *o = &gw->obstacles[sm->cursor++];
+            if ( !o->dynamic || o->lodLevel != PHYSICS_LOD_FULL || !b2Body_IsAwake( o->bodyId ) ) {
+                continue;
+            }
+
+            b2Vec2 p = b2Body_GetPosition( o->bodyId );
+            if ( CheckCollisionPointRec( (Vector2){ p.x, p.y }, sm->activeRegion ) ) {
+                continue;
+            }
+
+            // sleeping a body sleeps its whole island, so it must be
+            // settled, not only slow, like the level of detail sleep
+            if ( isObstacleSlow( o ) ) {
+                b2Body_SetAwake( o->bodyId, false );
+                sm->forcedSleeps++;
+            }
+
+        }
+
+        b2AABB aabb = {
+            { focus.x - sm->wakeRadius, focus.y - sm->wakeRadius },
+            { focus.x + sm->wakeRadius, focus.y + sm->wakeRadius }
+        };
+        b2World_OverlapAABB( gw->worldId, aabb, b2DefaultQueryFilter(), wakeBodyCallback, &sm->proximityWakes );
+
+    }
+
+    int dynamicBodies = 1;
+    for ( int i = 0; i < gw->obstaclesQuantity; i++ ) {
+        if ( gw->obstacles[i].dynamic && gw->obstacles[i].lodLevel != PHYSICS_LOD_DISABLED ) {
+            dynamicBodies++;
+        }
+    }
+
+    sm->awakeBodies = b2World_GetAwakeBodyCount( gw->worldId );
+    sm->sleepingBodies = dynamicBodies - sm->awakeBodies;
+    sm->islands = b2World_GetCounters( gw->worldId ).islandCount;
+
+}
+
+/**
+ * @brief Draws the awake/asleep counters and island statistics.
+ */
+void drawSleepStats( const SleepManager *sm, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "awake: %d asleep: %d islands: %d (avg %.1f bodies) forced: %d woken: %d",
+            sm->awakeBodies, sm->sleepingBodies, sm->islands,
+            sm->islands > 0 ? (float) ( sm->awakeBodies + sm->sleepingBodies ) / sm->islands : 0.0f,
+            sm->forcedSleeps, sm->proximityWakes
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
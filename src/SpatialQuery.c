@@ -0,0 +1,508 @@
+/**
+ * @file SpatialQuery.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Batched spatial query service implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "SpatialQuery.h"
+#include "Memory.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+typedef struct SpatialQueryWorker {
+    SpatialQueryService *sqs;
+    b2WorldId worldId;
+    int *indices;
+    int first;
+    int last;
+    b2TreeStats treeStats;
+} SpatialQueryWorker;
+
+typedef struct SpatialQueryThread {
+    SpatialQueryWorkerPool *pool;
+    int index;
+} SpatialQueryThread;
+
+/**
+ * @brief Threads waiting for the chunks of the batches. A batch bumps
+ * generation and wakes them, each one runs its chunk and the last one to
+ * finish wakes the calling thread, which runs the first chunk itself.
+ */
+struct SpatialQueryWorkerPool {
+
+    SpatialQueryWorker workers[SPATIAL_QUERY_MAX_THREADS];
+    SpatialQueryThread threadData[SPATIAL_QUERY_MAX_THREADS];
+    pthread_t threads[SPATIAL_QUERY_MAX_THREADS];
+
+    // the first chunk has no thread, started counts the others
+    int started;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t batchCondition;
+    pthread_cond_t doneCondition;
+    int generation;
+    int remaining;
+    bool running;
+
+};
+
+static int cellCoord( float value, float cellSize ) {
+    return (int) floorf( value / cellSize );
+}
+
+static SpatialQueryKey makeKey( SpatialQueryService *sqs, SpatialQueryType type, b2Vec2 origin, b2Vec2 target, b2QueryFilter filter ) {
+    return (SpatialQueryKey) {
+        .type = type,
+        .originCellX = cellCoord( origin.x, sqs->cacheCellSize ),
+        .originCellY = cellCoord( origin.y, sqs->cacheCellSize ),
+        .targetCellX = cellCoord( target.x, sqs->cacheCellSize ),
+        .targetCellY = cellCoord( target.y, sqs->cacheCellSize ),
+        .maskBits = filter.maskBits
+    };
+}
+
+static bool keysEqual( const SpatialQueryKey *a, const SpatialQueryKey *b ) {
+    return a->type == b->type &&
+           a->originCellX == b->originCellX && a->originCellY == b->originCellY &&
+           a->targetCellX == b->targetCellX && a->targetCellY == b->targetCellY &&
+           a->maskBits == b->maskBits;
+}
+
+static int cacheSlot( const SpatialQueryKey *key ) {
+    uint32_t h = 2166136261u;
+    int values[5] = { key->type, key->originCellX, key->originCellY, key->targetCellX, key->targetCellY };
+    for ( int i = 0; i < 5; i++ ) {
+        h = ( h ^ (uint32_t) values[i] ) * 16777619u;
+    }
+    h = ( h ^ (uint32_t) key->maskBits ) * 16777619u;
+    return (int) ( h & ( SPATIAL_QUERY_CACHE_SIZE - 1 ) );
+}
+
+static int enqueueQuery( SpatialQueryService *sqs, SpatialQuery *q ) {
+
+    if ( sqs->queryQuantity >= MAX_SPATIAL_QUERIES ) {
+        return -1;
+    }
+
+    sqs->stats.requested++;
+
+    if ( sqs->cacheTicks > 0 ) {
+        SpatialQueryCacheEntry *e = &sqs->cache[cacheSlot( &q->key )];
+        if ( e->used && e->expirationTick > sqs->tick && keysEqual( &e->key, &q->key ) ) {
+            q->result = e->result;
+            q->pending = false;
+            sqs->stats.cacheHits++;
+        }
+    }
+
+    int handle = sqs->queryQuantity++;
+    sqs->queries[handle] = *q;
+
+    return handle;
+
+}
+
+static float closestCastCallback( b2ShapeId shapeId, b2Vec2 point, b2Vec2 normal, float fraction, void *context ) {
+
+    SpatialQueryResult *r = (SpatialQueryResult*) context;
+
+    r->hit = true;
+    r->shapeId = shapeId;
+    r->point = point;
+    r->normal = normal;
+    r->fraction = fraction;
+
+    // clips the query to the current hit, so only closer hits are reported
+    return fraction;
+
+}
+
+static bool overlapCallback( b2ShapeId shapeId, void *context ) {
+
+    SpatialQueryResult *r = (SpatialQueryResult*) context;
+
+    if ( !r->hit ) {
+        r->hit = true;
+        r->shapeId = shapeId;
+    }
+    r->overlapQuantity++;
+
+    return true;
+
+}
+
+static b2TreeStats executeQuery( SpatialQuery *q, b2WorldId worldId ) {
+
+    q->result = (SpatialQueryResult) { .shapeId = b2_nullShapeId, .fraction = 1.0f };
+    b2TreeStats ts = { 0 };
+
+    switch ( q->type ) {
+        case SPATIAL_QUERY_RAY:
+            ts = b2World_CastRay( worldId, q->origin, q->translation, q->filter, closestCastCallback, &q->result );
+            break;
+        case SPATIAL_QUERY_AABB:
+            ts = b2World_OverlapAABB( worldId, q->aabb, q->filter, overlapCallback, &q->result );
+            break;
+        case SPATIAL_QUERY_SHAPE_CAST:
+            ts = b2World_CastShape( worldId, &q->proxy, q->translation, q->filter, closestCastCallback, &q->result );
+            break;
+    }
+
+    q->pending = false;
+
+    return ts;
+
+}
+
+static void *runSpatialQueryWorker( void *data ) {
+
+    SpatialQueryWorker *w = (SpatialQueryWorker*) data;
+
+    for ( int i = w->first; i < w->last; i++ ) {
+        b2TreeStats ts = executeQuery( &w->sqs->queries[w->indices[i]], w->worldId );
+        w->treeStats.nodeVisits += ts.nodeVisits;
+        w->treeStats.leafVisits += ts.leafVisits;
+    }
+
+    return NULL;
+
+}
+
+static void *runSpatialQueryThread( void *data ) {
+
+    SpatialQueryThread *t = (SpatialQueryThread*) data;
+    SpatialQueryWorkerPool *pool = t->pool;
+    int seen = 0;
+
+    pthread_mutex_lock( &pool->mutex );
+
+    while ( true ) {
+
+        while ( pool->running && pool->generation == seen ) {
+            pthread_cond_wait( &pool->batchCondition, &pool->mutex );
+        }
+        if ( !pool->running ) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock( &pool->mutex );
+
+        runSpatialQueryWorker( &pool->workers[t->index] );
+
+        pthread_mutex_lock( &pool->mutex );
+        if ( --pool->remaining == 0 ) {
+            pthread_cond_signal( &pool->doneCondition );
+        }
+
+    }
+
+    pthread_mutex_unlock( &pool->mutex );
+
+    return NULL;
+
+}
+
+static SpatialQueryWorkerPool *createSpatialQueryWorkerPool( void ) {
+
+    SpatialQueryWorkerPool *pool = (SpatialQueryWorkerPool*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( SpatialQueryWorkerPool ) );
+
+    pthread_mutex_init( &pool->mutex, NULL );
+    pthread_cond_init( &pool->batchCondition, NULL );
+    pthread_cond_init( &pool->doneCondition, NULL );
+    pool->generation = 0;
+    pool->remaining = 0;
+    pool->running = true;
+    pool->started = 0;
+
+    // the chunks without a thread are run by the calling thread
+    for ( int i = 1; i < SPATIAL_QUERY_MAX_THREADS; i++ ) {
+        pool->threadData[i] = (SpatialQueryThread) { pool, i };
+        if ( pthread_create( &pool->threads[i], NULL, runSpatialQueryThread, &pool->threadData[i] ) != 0 ) {
+            TraceLog( LOG_WARNING, "QUERY: could not start worker %d", i );
+            break;
+        }
+        pool->started++;
+    }
+
+    return pool;
+
+}
+
+static void destroySpatialQueryWorkerPool( SpatialQueryWorkerPool *pool ) {
+
+    pthread_mutex_lock( &pool->mutex );
+    pool->running = false;
+    pthread_cond_broadcast( &pool->batchCondition );
+    pthread_mutex_unlock( &pool->mutex );
+
+    for ( int i = 1; i <= pool->started; i++ ) {
+        pthread_join( pool->threads[i], NULL );
+    }
+
+    pthread_cond_destroy( &pool->doneCondition );
+    pthread_cond_destroy( &pool->batchCondition );
+    pthread_mutex_destroy( &pool->mutex );
+
+    freeMemory( pool );
+
+}
+
+/**
+ * @brief Initializes the query service. Cached results are reused while
+ * the query origin and target stay in the same cells of cacheCellSize
+ * units, for at most cacheTicks ticks.
+ */
+void initSpatialQueryService( SpatialQueryService *sqs, float cacheCellSize, int cacheTicks ) {
+
+    sqs->queryQuantity = 0;
+    sqs->cacheCellSize = cacheCellSize;
+    sqs->cacheTicks = cacheTicks;
+    sqs->tick = 0;
+    sqs->parallel = false;
+    sqs->parallelThreshold = 64;
+    sqs->workers = NULL;
+    sqs->stats = (SpatialQueryStats) { 0 };
+
+    for ( int i = 0; i < SPATIAL_QUERY_CACHE_SIZE; i++ ) {
+        sqs->cache[i].used = false;
+    }
+
+}
+
+/**
+ * @brief Stops the worker threads of the service, if they were started.
+ */
+void destroySpatialQueryService( SpatialQueryService *sqs ) {
+    if ( sqs->workers != NULL ) {
+        destroySpatialQueryWorkerPool( sqs->workers );
+        sqs->workers = NULL;
+    }
+}
+
+/**
+ * @brief Drops the pending queries and the cached results, which refer
+ * to shapes of the previous level.
+ */
+void clearSpatialQueryCache( SpatialQueryService *sqs ) {
+
+    sqs->queryQuantity = 0;
+
+    for ( int i = 0; i < SPATIAL_QUERY_CACHE_SIZE; i++ ) {
+        sqs->cache[i].used = false;
+    }
+
+}
+
+/**
+ * @brief Starts a new tick, discarding the queries of the previous one.
+ */
+void beginSpatialQueryTick( SpatialQueryService *sqs ) {
+    sqs->tick++;
+    sqs->queryQuantity = 0;
+    sqs->stats = (SpatialQueryStats) { 0 };
+}
+
+/**
+ * @brief Requests a closest hit ray cast. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestRayQuery( SpatialQueryService *sqs, b2Vec2 origin, b2Vec2 translation, b2QueryFilter filter ) {
+
+    SpatialQuery q = {
+        .type = SPATIAL_QUERY_RAY,
+        .origin = origin,
+        .translation = translation,
+        .filter = filter,
+        .pending = true
+    };
+    q.key = makeKey( sqs, q.type, origin, b2Add( origin, translation ), filter );
+
+    return enqueueQuery( sqs, &q );
+
+}
+
+/**
+ * @brief Requests an AABB overlap query. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestAABBQuery( SpatialQueryService *sqs, b2AABB aabb, b2QueryFilter filter ) {
+
+    SpatialQuery q = {
+        .type = SPATIAL_QUERY_AABB,
+        .origin = aabb.lowerBound,
+        .aabb = aabb,
+        .filter = filter,
+        .pending = true
+    };
+    q.key = makeKey( sqs, q.type, aabb.lowerBound, aabb.upperBound, filter );
+
+    return enqueueQuery( sqs, &q );
+
+}
+
+/**
+ * @brief Requests a closest hit shape cast. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestShapeCastQuery( SpatialQueryService *sqs, const b2ShapeProxy *proxy, b2Vec2 translation, b2QueryFilter filter ) {
+
+    SpatialQuery q = {
+        .type = SPATIAL_QUERY_SHAPE_CAST,
+        .origin = proxy->points[0],
+        .translation = translation,
+        .proxy = *proxy,
+        .filter = filter,
+        .pending = true
+    };
+    q.key = makeKey( sqs, q.type, q.origin, b2Add( q.origin, translation ), filter );
+
+    return enqueueQuery( sqs, &q );
+
+}
+
+/**
+ * @brief Executes all pending queries of the tick in one batch. Must be
+ * called while the world is not being stepped.
+ */
+void executeSpatialQueries( SpatialQueryService *sqs, b2WorldId worldId ) {
+
+    double start = GetTime();
+
+    int pending[MAX_SPATIAL_QUERIES];
+    int pendingQuantity = 0;
+
+    for ( int i = 0; i < sqs->queryQuantity; i++ ) {
+        SpatialQuery *q = &sqs->queries[i];
+        if ( q->pending ) {
+            pending[pendingQuantity++] = i;
+            switch ( q->type ) {
+                case SPATIAL_QUERY_RAY: sqs->stats.rays++; break;
+                case SPATIAL_QUERY_AABB: sqs->stats.aabbs++; break;
+                case SPATIAL_QUERY_SHAPE_CAST: sqs->stats.shapeCasts++; break;
+            }
+        }
+    }
+
+    if ( pendingQuantity == 0 ) {
+        return;
+    }
+
+    // world queries are read only, so the batch can be split among threads
+    int threadQuantity = 1;
+    if ( sqs->parallel && pendingQuantity >= sqs->parallelThreshold ) {
+        threadQuantity = SPATIAL_QUERY_MAX_THREADS;
+    }
+
+    // the threads are started once and then only woken up per batch
+    SpatialQueryWorkerPool *pool = NULL;
+    if ( threadQuantity > 1 ) {
+        if ( sqs->workers == NULL ) {
+            sqs->workers = createSpatialQueryWorkerPool();
+        }
+        pool = sqs->workers;
+        threadQuantity = pool->started + 1;
+    }
+
+    SpatialQueryWorker serialWorker;
+    SpatialQueryWorker *workers = pool != NULL ? pool->workers : &serialWorker;
+    int chunk = ( pendingQuantity + threadQuantity - 1 ) / threadQuantity;
+
+    for ( int i = 0; i < threadQuantity; i++ ) {
+        workers[i] = (SpatialQueryWorker) {
+            .sqs = sqs,
+            .worldId = worldId,
+            .indices = pending,
+            .first = i * chunk,
+            .last = ( i + 1 ) * chunk < pendingQuantity ? ( i + 1 ) * chunk : pendingQuantity
+        };
+    }
+
+    if ( pool != NULL && threadQuantity > 1 ) {
+        pthread_mutex_lock( &pool->mutex );
+        pool->remaining = threadQuantity - 1;
+        pool->generation++;
+        pthread_cond_broadcast( &pool->batchCondition );
+        pthread_mutex_unlock( &pool->mutex );
+    }
+
+    // the calling thread takes the first chunk
+    runSpatialQueryWorker( &workers[0] );
+
+    if ( pool != NULL && threadQuantity > 1 ) {
+        pthread_mutex_lock( &pool->mutex );
+        while ( pool->remaining > 0 ) {
+            pthread_cond_wait( &pool->doneCondition, &pool->mutex );
+        }
+        pthread_mutex_unlock( &pool->mutex );
+    }
+
+    for ( int i = 0; i < threadQuantity; i++ ) {
+        sqs->stats.treeStats.nodeVisits += workers[i].treeStats.nodeVisits;
+        sqs->stats.treeStats.leafVisits += workers[i].treeStats.leafVisits;
+    }
+
+    sqs->stats.executed += pendingQuantity;
+    sqs->stats.threadsUsed = threadQuantity;
+
+    if ( sqs->cacheTicks > 0 ) {
+        for ( int i = 0; i < pendingQuantity; i++ ) {
+            SpatialQuery *q = &sqs->queries[pending[i]];
+            SpatialQueryCacheEntry *e = &sqs->cache[cacheSlot( &q->key )];
+            e->key = q->key;
+            e->result = q->result;
+            e->expirationTick = sqs->tick + sqs->cacheTicks;
+            e->used = true;
+        }
+    }
+
+    sqs->stats.executionTime = ( GetTime() - start ) * 1000.0;
+
+}
+
+/**
+ * @brief Returns the result of a query, or NULL if the handle is invalid
+ * or the query was not executed yet.
+ */
+const SpatialQueryResult* getSpatialQueryResult( const SpatialQueryService *sqs, int handle ) {
+
+    if ( handle < 0 || handle >= sqs->queryQuantity || sqs->queries[handle].pending ) {
+        return NULL;
+    }
+
+    return &sqs->queries[handle].result;
+
+}
+
+/**
+ * @brief Draws the query counters and tree statistics of the last tick.
+ */
+void drawSpatialQueryStats( const SpatialQueryStats *stats, int x, int y ) {
+
+    DrawText(
+        TextFormat(
+            "queries: %d (%d executed, %d cached) ray: %d aabb: %d cast: %d",
+            stats->requested, stats->executed, stats->cacheHits,
+            stats->rays, stats->aabbs, stats->shapeCasts
+        ),
+        x, y, 10, DARKGRAY
+    );
+
+    DrawText(
+        TextFormat(
+            "tree nodes: %d leaves: %d threads: %d time: %.3fms",
+            stats->treeStats.nodeVisits, stats->treeStats.leafVisits,
+            stats->threadsUsed, stats->executionTime
+        ),
+        x, y + 12, 10, DARKGRAY
+    );
+
+}
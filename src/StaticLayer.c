@@ -0,0 +1,272 @@
+/**
+ * @file StaticLayer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Static background layer implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "StaticLayer.h"
+#include "Memory.h"
+#include "Obstacle.h"
+#include "ChainObstacle.h"
+#include "DrawingUtils.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+
+static Rectangle obstacleBounds( const Obstacle *o ) {
+    return (Rectangle){ o->position.x - o->dim.x / 2, o->position.y - o->dim.y / 2, o->dim.x, o->dim.y };
+}
+
+static Rectangle chainBounds( b2Vec2 min, b2Vec2 max ) {
+    // room for the outline and the labels, drawn right/below the vertices
+    return (Rectangle){ min.x - 2, min.y - 2, max.x - min.x + 120, max.y - min.y + 14 };
+}
+
+static Rectangle chainObstacleBounds( const ChainObstacle *co ) {
+
+    b2Vec2 min = co->points[0];
+    b2Vec2 max = co->points[0];
+
+    for ( int i = 1; i < co->pointQuantity; i++ ) {
+        min = b2Min( min, co->points[i] );
+        max = b2Max( max, co->points[i] );
+    }
+
+    return chainBounds( min, max );
+
+}
+
+static void unloadTiles( StaticLayer *sl ) {
+    for ( int i = 0; i < sl->columns * sl->rows; i++ ) {
+        if ( sl->tiles[i].target.id != 0 ) {
+            UnloadRenderTexture( sl->tiles[i].target );
+            sl->tiles[i].target = (RenderTexture2D) { 0 };
+        }
+    }
+}
+
+static void layoutTiles( StaticLayer *sl ) {
+
+    unloadTiles( sl );
+
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+
+    sl->tileSize = STATIC_LAYER_TILE_SIZE;
+    sl->columns = ( width + sl->tileSize - 1 ) / sl->tileSize;
+    sl->rows = ( height + sl->tileSize - 1 ) / sl->tileSize;
+
+    while ( sl->columns * sl->rows > STATIC_LAYER_MAX_TILES ) {
+        sl->tileSize *= 2;
+        sl->columns = ( width + sl->tileSize - 1 ) / sl->tileSize;
+        sl->rows = ( height + sl->tileSize - 1 ) / sl->tileSize;
+    }
+
+    for ( int r = 0; r < sl->rows; r++ ) {
+        for ( int c = 0; c < sl->columns; c++ ) {
+            StaticLayerTile *t = &sl->tiles[r * sl->columns + c];
+            t->target = (RenderTexture2D) { 0 };
+            t->bounds = (Rectangle){ c * sl->tileSize, r * sl->tileSize, sl->tileSize, sl->tileSize };
+            t->dirty = true;
+            t->empty = true;
+        }
+    }
+
+}
+
+static void markTiles( StaticLayer *sl, Rectangle bounds ) {
+    for ( int i = 0; i < sl->columns * sl->rows; i++ ) {
+        if ( CheckCollisionRecs( sl->tiles[i].bounds, bounds ) ) {
+            sl->tiles[i].dirty = true;
+        }
+    }
+}
+
+static void rebuildTile( StaticLayer *sl, StaticLayerTile *t, RenderSnapshot *rs ) {
+
+    t->dirty = false;
+    t->empty = true;
+
+    for ( int i = 0; i < rs->obstaclesQuantity && t->empty; i++ ) {
+        if ( !rs->obstacles[i].dynamic && CheckCollisionRecs( t->bounds, obstacleBounds( &rs->obstacles[i] ) ) ) {
+            t->empty = false;
+        }
+    }
+
+    for ( int i = 0; i < rs->chainObstacleQuantity && t->empty; i++ ) {
+        if ( CheckCollisionRecs( t->bounds, chainObstacleBounds( &rs->chainObstacles[i] ) ) ) {
+            t->empty = false;
+        }
+    }
+
+    if ( t->empty ) {
+        return;
+    }
+
+    if ( t->target.id == 0 ) {
+        t->target = LoadRenderTexture( sl->tileSize, sl->tileSize );
+    }
+
+    BeginTextureMode( t->target );
+    ClearBackground( BLANK );
+
+    rlPushMatrix();
+    rlTranslatef( -t->bounds.x, -t->bounds.y, 0.0f );
+
+    for ( int i = 0; i < rs->obstaclesQuantity; i++ ) {
+        Obstacle *o = &rs->obstacles[i];
+        if ( !o->dynamic && CheckCollisionRecs( t->bounds, obstacleBounds( o ) ) ) {
+            drawObstacle( o );
+        }
+    }
+
+    // render textures have no stencil attachment
+    setConcaveFillMode( CONCAVE_FILL_TRIANGULATE );
+    for ( int i = 0; i < rs->chainObstacleQuantity; i++ ) {
+        ChainObstacle *co = &rs->chainObstacles[i];
+        if ( CheckCollisionRecs( t->bounds, chainObstacleBounds( co ) ) ) {
+            drawChainObstacle( co );
+        }
+    }
+
+    if ( sl->labels ) {
+        for ( int i = 0; i < rs->chainObstacleQuantity; i++ ) {
+            ChainObstacle *co = &rs->chainObstacles[i];
+            if ( CheckCollisionRecs( t->bounds, chainObstacleBounds( co ) ) ) {
+                drawChainObstacleLabels( co );
+            }
+        }
+    }
+
+    rlPopMatrix();
+    EndTextureMode();
+
+    sl->rebuiltTiles++;
+    sl->totalRebuilds++;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated StaticLayer struct instance.
+ * Needs an OpenGL context.
+ */
+StaticLayer* createStaticLayer( void ) {
+
+    StaticLayer *sl = (StaticLayer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( StaticLayer ) );
+
+    sl->tileSize = STATIC_LAYER_TILE_SIZE;
+    sl->columns = 0;
+    sl->rows = 0;
+    sl->revision = 0;
+    sl->builtTick = -1;
+    sl->carvedRegions = 0;
+    sl->labels = false;
+    sl->valid = false;
+    sl->drawnTiles = 0;
+    sl->rebuiltTiles = 0;
+    sl->totalRebuilds = 0;
+
+    return sl;
+
+}
+
+/**
+ * @brief Destroys a StaticLayer object and its render textures.
+ */
+void destroyStaticLayer( StaticLayer *sl ) {
+    unloadTiles( sl );
+    freeMemory( sl );
+}
+
+/**
+ * @brief Marks every tile as outdated.
+ */
+void invalidateStaticLayer( StaticLayer *sl ) {
+    sl->valid = false;
+}
+
+/**
+ * @brief Renders the outdated tiles of the static entities of the
+ * snapshot. Must be called between BeginDrawing and EndDrawing, outside
+ * of any other texture mode.
+ */
+void updateStaticLayer( StaticLayer *sl, RenderSnapshot *rs, bool labels ) {
+
+    sl->rebuiltTiles = 0;
+
+    if ( sl->columns * sl->tileSize < GetScreenWidth() || sl->rows * sl->tileSize < GetScreenHeight() ||
+         ( sl->columns - 1 ) * sl->tileSize >= GetScreenWidth() || ( sl->rows - 1 ) * sl->tileSize >= GetScreenHeight() ) {
+        layoutTiles( sl );
+    }
+
+    // the carved regions older than the history can't be repainted alone
+    int carvedRegions = rs->carver.regionTotal - sl->carvedRegions;
+
+    if ( !sl->valid || sl->revision != rs->staticRevision || sl->labels != labels || rs->capturedTick < sl->builtTick ||
+         carvedRegions < 0 || carvedRegions > CARVED_REGION_HISTORY ) {
+        for ( int i = 0; i < sl->columns * sl->rows; i++ ) {
+            sl->tiles[i].dirty = true;
+        }
+    } else {
+        // contacts recolor static entities without changing the revision
+        for ( int i = 0; i < rs->obstaclesQuantity; i++ ) {
+            Obstacle *o = &rs->obstacles[i];
+            if ( !o->dynamic && o->changedTick > sl->builtTick ) {
+                markTiles( sl, obstacleBounds( o ) );
+            }
+        }
+        for ( int i = 0; i < rs->chainObstacleQuantity; i++ ) {
+            ChainObstacle *co = &rs->chainObstacles[i];
+            if ( co->changedTick > sl->builtTick ) {
+                markTiles( sl, chainObstacleBounds( co ) );
+            }
+        }
+        // geometry carved away is covered by no chain anymore
+        for ( int i = sl->carvedRegions; i < rs->carver.regionTotal; i++ ) {
+            b2AABB region = rs->carver.regions[i % CARVED_REGION_HISTORY];
+            markTiles( sl, chainBounds( region.lowerBound, region.upperBound ) );
+        }
+    }
+
+    sl->revision = rs->staticRevision;
+    sl->builtTick = rs->capturedTick;
+    sl->carvedRegions = rs->carver.regionTotal;
+    sl->labels = labels;
+    sl->valid = true;
+
+    for ( int i = 0; i < sl->columns * sl->rows; i++ ) {
+        StaticLayerTile *t = &sl->tiles[i];
+        if ( t->dirty ) {
+            rebuildTile( sl, t, rs );
+        }
+    }
+
+}
+
+/**
+ * @brief Draws the non empty tiles updated by updateStaticLayer.
+ */
+void drawStaticLayer( StaticLayer *sl ) {
+
+    sl->drawnTiles = 0;
+
+    for ( int i = 0; i < sl->columns * sl->rows; i++ ) {
+        StaticLayerTile *t = &sl->tiles[i];
+        if ( !t->empty ) {
+            // render textures are stored upside down
+            DrawTextureRec( 
+                t->target.texture, 
+                (Rectangle){ 0, 0, sl->tileSize, -sl->tileSize }, 
+                (Vector2){ t->bounds.x, t->bounds.y }, 
+                WHITE 
+            );
+            sl->drawnTiles++;
+        }
+    }
+
+}
@@ -0,0 +1,234 @@
+/**
+ * @file StressScene.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Procedural stress scene implementation.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "StressScene.h"
+#include "Memory.h"
+#include "Random.h"
+#include "GameWorld.h"
+#include "Obstacle.h"
+#include "ChainObstacle.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#define STRESS_SCENE_MARGIN 40.0f
+
+static b2Vec2 randomPosition( uint32_t *state, GameWorld *gw, float minY, float maxY ) {
+
+    b2Vec2 spawn = gw->player.position;
+
+    // keeps the player spawn area free
+    for ( int i = 0; i < 16; i++ ) {
+        b2Vec2 p = {
+            randomRange( state, STRESS_SCENE_MARGIN, gw->width - STRESS_SCENE_MARGIN ),
+            randomRange( state, minY, maxY )
+        };
+        if ( b2Distance( p, spawn ) > 80.0f ) {
+            return p;
+        }
+    }
+
+    return (b2Vec2){ STRESS_SCENE_MARGIN, minY };
+
+}
+
+/**
+ * @brief Adds to the world, inside its walls, boxObstacles static boxes,
+ * chainObstacles random star shaped chains of chainVertices vertices and
+ * dynamicBodies boxes dropped from the top. Quantities are clamped to
+ * the free entity slots. The chain cleanup may remove a few vertices.
+ */
+void generateStressScene( GameWorld *gw, const StressSceneConfig *config ) {
+
+    uint32_t state = config->seed != 0 ? config->seed : 1;
+    float bottom = gw->height - STRESS_SCENE_MARGIN;
+
+    int boxes = config->boxObstacles;
+    if ( boxes > MAX_OBSTACLES - gw->obstaclesQuantity ) {
+        boxes = MAX_OBSTACLES - gw->obstaclesQuantity;
+    }
+
+    for ( int i = 0; i < boxes; i++ ) {
+        b2Vec2 p = randomPosition( &state, gw, STRESS_SCENE_MARGIN * 3, bottom );
+        createObstacle( p.x, p.y, randomRange( &state, 10, 40 ), randomRange( &state, 10, 40 ), ORANGE, SHAPE_FLAG_NONE, gw );
+    }
+
+    int chains = config->chainObstacles;
+    if ( chains > MAX_CHAIN_OBSTACLES - gw->chainObstacleQuantity ) {
+        chains = MAX_CHAIN_OBSTACLES - gw->chainObstacleQuantity;
+    }
+
+    int vertices = config->chainVertices;
+    if ( vertices < 3 ) {
+        vertices = 3;
+    } else if ( vertices > MAX_CHAIN_OBSTACLE_POINTS - 1 ) {
+        vertices = MAX_CHAIN_OBSTACLE_POINTS - 1;
+    }
+
+    b2Vec2 points[MAX_CHAIN_OBSTACLE_POINTS];
+
+    for ( int i = 0; i < chains; i++ ) {
+
+        b2Vec2 center = randomPosition( &state, gw, STRESS_SCENE_MARGIN * 3, bottom );
+        float radius = randomRange( &state, 15, 40 );
+
+        // jittered radii around growing angles: star shaped, so simple,
+        // with the same winding of the hand made chains
+        for ( int j = 0; j < vertices; j++ ) {
+            float a = 2.0f * PI * ( j + randomRange( &state, 0.0f, 0.5f ) ) / vertices;
+            float r = radius * randomRange( &state, 0.5f, 1.0f );
+            points[j] = (b2Vec2){ center.x + r * cosf( a ), center.y + r * sinf( a ) };
+        }
+
+        createChainObstacle( points, vertices, ORANGE, true, SHAPE_FLAG_NONE, gw );
+
+    }
+
+    int dynamicBodies = config->dynamicBodies;
+    if ( dynamicBodies > MAX_OBSTACLES - gw->obstaclesQuantity ) {
+        dynamicBodies = MAX_OBSTACLES - gw->obstaclesQuantity;
+    }
+
+    for ( int i = 0; i < dynamicBodies; i++ ) {
+        b2Vec2 p = randomPosition( &state, gw, STRESS_SCENE_MARGIN, gw->height / 4 );
+        float size = randomRange( &state, 8, 20 );
+        createDynamicObstacle( p.x, p.y, size, size, BROWN, gw );
+    }
+
+}
+
+/**
+ * @brief Adds the timings of one frame to a report.
+ */
+void addStressReportSample( StressReport *sr, double frameTime, double updateTime, double stepTime,
+                            double captureTime, double drawTime, double gpuTime ) {
+
+    sr->frames++;
+    sr->frameTime += frameTime;
+    sr->updateTime += updateTime;
+    sr->stepTime += stepTime;
+    sr->captureTime += captureTime;
+    sr->drawTime += drawTime;
+    sr->gpuTime += gpuTime;
+
+    if ( frameTime > sr->maxFrameTime ) {
+        sr->maxFrameTime = frameTime;
+    }
+
+}
+
+/**
+ * @brief Appends the averages of a report as a CSV row, writing the
+ * header first if the file is new. Returns false if the file can't be
+ * written.
+ */
+bool writeStressReport( const char *fileName, const char *mode, const StressSceneConfig *config,
+                        GameWorld *gw, const StressReport *sr ) {
+
+    FILE *f = fopen( fileName, "a" );
+    if ( f == NULL ) {
+        TraceLog( LOG_WARNING, "STRESS: could not write the report %s", fileName );
+        return false;
+    }
+
+    if ( ftell( f ) == 0 ) {
+        fprintf( f, "mode,seed,boxes,chains,chainVertices,dynamicBodies,bodies,shapes,contacts,frames,"
+                    "avgFrameMs,maxFrameMs,avgUpdateMs,avgStepMs,avgCaptureMs,avgDrawMs,avgGpuMs,loadMs,chainMode\n" );
+    }
+
+    b2Counters counters = b2World_GetCounters( gw->worldId );
+    double frames = sr->frames > 0 ? sr->frames : 1;
+
+    fprintf( 
+        f, "%s,%u,%d,%d,%d,%d,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%s\n",
+        mode, config->seed, config->boxObstacles, config->chainObstacles, config->chainVertices, config->dynamicBodies,
+        counters.bodyCount, counters.shapeCount, counters.contactCount, sr->frames,
+        sr->frameTime / frames, sr->maxFrameTime, sr->updateTime / frames, sr->stepTime / frames,
+        sr->captureTime / frames, sr->drawTime / frames, sr->gpuTime / frames, gw->levelLoadTime,
+        gw->solidChainObstacles ? "solid" : "hollow"
+    );
+
+    fclose( f );
+
+    return true;
+
+}
+
+/**
+ * @brief Runs the simulation without a window for scaling tests: for
+ * each step i from 1 to steps, a world with the quantities of the config
+ * times i is generated and simulated for frames fixed time steps, and
+ * its timings are appended to the report file. Every step runs with
+ * hollow and with solid chain obstacles, to compare their costs.
+ */
+void runHeadlessStressTest( const StressSceneConfig *config, int steps, int frames, const char *fileName ) {
+
+    // raylib timing needs a window, Box2D has its own timer
+    RenderSnapshot *rs = (RenderSnapshot*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( RenderSnapshot ) );
+    GameInput input = { 0 };
+    float delta = 1.0f / 60.0f;
+
+    // one world for every step, each one reloads the stress level
+    GameWorld *gw = createGameWorld( 800, 450 );
+    int level = addGameWorldLevel( gw, &(LevelDef){ .name = "stress", .dummyObstacles = true, .stressScene = true } );
+
+    for ( int i = 1; i <= steps; i++ ) {
+
+        StressSceneConfig c = *config;
+        c.boxObstacles *= i;
+        c.chainObstacles *= i;
+        c.dynamicBodies *= i;
+
+        gw->levels[level].stressSceneConfig = c;
+
+        for ( int k = 0; k < 2; k++ ) {
+
+            gw->solidChainObstacles = k == 1;
+            loadGameWorldLevel( gw, level );
+
+            rs->capturedTick = -1;
+            rs->obstaclesQuantity = 0;
+            rs->chainObstacleQuantity = 0;
+
+            StressReport sr = { 0 };
+
+            for ( int j = 0; j < frames; j++ ) {
+
+                uint64_t ticks = b2GetTicks();
+                updateGameWorld( gw, &input, delta );
+                float updateTime = b2GetMillisecondsAndReset( &ticks );
+                captureRenderSnapshot( gw, rs );
+                float captureTime = b2GetMilliseconds( ticks );
+
+                addStressReportSample( &sr, updateTime + captureTime, updateTime, gw->stepTime, captureTime, 0.0, 0.0 );
+
+            }
+
+            TraceLog( 
+                LOG_INFO, "STRESS: %d boxes, %d %s chains, %d dynamic: %.3fms per frame (step %.3fms, load %.3fms, %d contacts)",
+                c.boxObstacles, c.chainObstacles, gw->solidChainObstacles ? "solid" : "hollow", c.dynamicBodies,
+                sr.frameTime / frames, sr.stepTime / frames, gw->levelLoadTime, b2World_GetCounters( gw->worldId ).contactCount
+            );
+
+            writeStressReport( fileName, "headless", &c, gw, &sr );
+
+        }
+
+    }
+
+    destroyGameWorld( gw );
+    freeMemory( rs );
+    logMemoryReport();
+
+}
@@ -0,0 +1,285 @@
+/**
+ * @file TerrainCarver.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Terrain carving implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "TerrainCarver.h"
+#include "ChainObstacle.h"
+#include "PolygonUtils.h"
+#include "SpatialQuery.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+// room for the pieces of one subtraction
+#define CARVE_RESULT_CAPACITY 256
+#define CARVE_MAX_PIECES 32
+
+static b2AABB chainObstacleAABB( const ChainObstacle *co ) {
+
+    b2AABB aabb = { co->points[0], co->points[0] };
+
+    for ( int i = 1; i < co->pointQuantity; i++ ) {
+        aabb.lowerBound = b2Min( aabb.lowerBound, co->points[i] );
+        aabb.upperBound = b2Max( aabb.upperBound, co->points[i] );
+    }
+
+    return aabb;
+
+}
+
+static bool aabbOverlaps( b2AABB a, b2AABB b ) {
+    return a.lowerBound.x <= b.upperBound.x && b.lowerBound.x <= a.upperBound.x &&
+           a.lowerBound.y <= b.upperBound.y && b.lowerBound.y <= a.upperBound.y;
+}
+
+static bool addCarvedPiece( b2Vec2 *points, int pointQuantity, Color color, unsigned int flags, GameWorld *gw ) {
+
+    if ( fabsf( computePolygonSignedArea( points, pointQuantity ) ) < TERRAIN_CARVER_MIN_AREA ) {
+        return false;
+    }
+
+    // the clip vertices add up, a piece may not fit in a chain obstacle
+    float tolerance = CHAIN_OBSTACLE_SIMPLIFY_TOLERANCE;
+    for ( int i = 0; i < 8 && pointQuantity >= MAX_CHAIN_OBSTACLE_POINTS; i++ ) {
+        pointQuantity = simplifyPolygon( points, pointQuantity, tolerance );
+        tolerance *= 2.0f;
+    }
+
+    if ( pointQuantity >= MAX_CHAIN_OBSTACLE_POINTS ) {
+        TraceLog( LOG_WARNING, "CARVE: piece of %d vertices dropped", pointQuantity );
+        return false;
+    }
+
+    return addChainObstacle( points, pointQuantity, color, true, flags, gw ) > 0;
+
+}
+
+/*
+ * Subtracts the request from the chain obstacle at r->chainCursor and
+ * advances the cursor. A removed obstacle is replaced by the last one,
+ * which is visited next if the request didn't create it.
+ */
+static bool carveChainObstacle( TerrainCarver *tc, CarveRequest *r, GameWorld *gw ) {
+
+    ChainObstacle *co = &gw->chainObstacles[r->chainCursor];
+
+    b2Vec2 result[CARVE_RESULT_CAPACITY];
+    int resultCounts[CARVE_MAX_PIECES];
+    int resultQuantity = 0;
+
+    // the last two points close the loop
+    PolygonSubtraction s = subtractPolygon(
+        co->points, co->pointQuantity - 2, r->points, r->pointQuantity,
+        result, CARVE_RESULT_CAPACITY, resultCounts, CARVE_MAX_PIECES, &resultQuantity
+    );
+
+    switch ( s ) {
+        case POLYGON_SUBTRACTION_DISJOINT:
+            r->chainCursor++;
+            return false;
+        case POLYGON_SUBTRACTION_HOLE:
+            // a chain is a single loop, it can't have a hole
+            tc->skippedHoles++;
+            r->chainCursor++;
+            return false;
+        case POLYGON_SUBTRACTION_FAILED:
+            TraceLog( LOG_WARNING, "CARVE: chain obstacle of %d vertices can't be carved", co->pointQuantity - 2 );
+            r->chainCursor++;
+            return false;
+        default:
+            break;
+    }
+
+    Color color = co->color;
+    unsigned int flags = co->flags;
+    int last = gw->chainObstacleQuantity - 1;
+
+    removeChainObstacle( r->chainCursor, gw );
+    if ( s == POLYGON_SUBTRACTION_REMOVED ) {
+        tc->removedChains++;
+    }
+
+    if ( last < r->chainEnd ) {
+        r->chainEnd--;
+    } else {
+        r->chainCursor++;
+    }
+
+    if ( s == POLYGON_SUBTRACTION_CLIPPED ) {
+        b2Vec2 *piece = result;
+        for ( int i = 0; i < resultQuantity; i++ ) {
+            if ( addCarvedPiece( piece, resultCounts[i], color, flags, gw ) ) {
+                tc->createdChains++;
+            }
+            piece += resultCounts[i];
+        }
+    }
+
+    tc->carvedChains++;
+    return true;
+
+}
+
+/**
+ * @brief Initializes an empty carver that subtracts at most budget chain
+ * obstacles per tick.
+ */
+void initTerrainCarver( TerrainCarver *tc, int budget ) {
+
+    tc->first = 0;
+    tc->quantity = 0;
+    tc->budget = budget;
+    tc->regionTotal = 0;
+
+    tc->carvedChains = 0;
+    tc->removedChains = 0;
+    tc->createdChains = 0;
+    tc->skippedHoles = 0;
+    tc->totalCarves = 0;
+    tc->carveTime = 0.0f;
+
+}
+
+/**
+ * @brief Drops the pending requests, e.g. when the level is unloaded.
+ */
+void clearTerrainCarver( TerrainCarver *tc ) {
+    tc->first = 0;
+    tc->quantity = 0;
+}
+
+/**
+ * @brief Queues the subtraction of a simple polygon from the chain
+ * obstacles. Returns false if the queue is full or the polygon has too
+ * many vertices.
+ */
+bool requestPolygonCarve( TerrainCarver *tc, const b2Vec2 *points, int pointQuantity ) {
+
+    if ( tc->quantity >= MAX_CARVE_REQUESTS || pointQuantity < 3 || pointQuantity > CARVE_MAX_VERTICES ) {
+        return false;
+    }
+
+    CarveRequest *r = &tc->requests[( tc->first + tc->quantity ) % MAX_CARVE_REQUESTS];
+    tc->quantity++;
+
+    r->bounds = (b2AABB){ points[0], points[0] };
+    for ( int i = 0; i < pointQuantity; i++ ) {
+        r->points[i] = points[i];
+        r->bounds.lowerBound = b2Min( r->bounds.lowerBound, points[i] );
+        r->bounds.upperBound = b2Max( r->bounds.upperBound, points[i] );
+    }
+    r->pointQuantity = pointQuantity;
+    r->started = false;
+
+    return true;
+
+}
+
+/**
+ * @brief Queues the subtraction of a circle, approximated by a regular
+ * polygon.
+ */
+bool requestCircleCarve( TerrainCarver *tc, b2Vec2 center, float radius ) {
+
+    b2Vec2 points[TERRAIN_CARVER_CIRCLE_VERTICES];
+
+    for ( int i = 0; i < TERRAIN_CARVER_CIRCLE_VERTICES; i++ ) {
+        float angle = 2.0f * PI * i / TERRAIN_CARVER_CIRCLE_VERTICES;
+        points[i] = (b2Vec2){ center.x + cosf( angle ) * radius, center.y + sinf( angle ) * radius };
+    }
+
+    return requestPolygonCarve( tc, points, TERRAIN_CARVER_CIRCLE_VERTICES );
+
+}
+
+/**
+ * @brief Subtracts the pending requests from the chain obstacles they
+ * overlap, rebuilding only those, until the budget of the tick is spent.
+ */
+void updateTerrainCarver( TerrainCarver *tc, GameWorld *gw ) {
+
+    tc->carvedChains = 0;
+    tc->removedChains = 0;
+    tc->createdChains = 0;
+
+    if ( tc->quantity == 0 ) {
+        tc->carveTime = 0.0f;
+        return;
+    }
+
+    uint64_t ticks = b2GetTicks();
+    int budget = tc->budget;
+    bool changed = false;
+    b2AABB region = { 0 };
+
+    while ( tc->quantity > 0 && budget > 0 ) {
+
+        CarveRequest *r = &tc->requests[tc->first];
+
+        if ( !r->started ) {
+            r->started = true;
+            r->chainCursor = 0;
+            r->chainEnd = gw->chainObstacleQuantity;
+        }
+
+        while ( r->chainCursor < r->chainEnd && budget > 0 ) {
+
+            ChainObstacle *co = &gw->chainObstacles[r->chainCursor];
+            b2AABB aabb = chainObstacleAABB( co );
+
+            // only the overlapping chains cost a subtraction
+            if ( !aabbOverlaps( aabb, r->bounds ) ) {
+                r->chainCursor++;
+                continue;
+            }
+
+            budget--;
+            if ( carveChainObstacle( tc, r, gw ) ) {
+                region = changed ? b2AABB_Union( region, aabb ) : aabb;
+                changed = true;
+            }
+
+        }
+
+        if ( r->chainCursor >= r->chainEnd ) {
+            tc->first = ( tc->first + 1 ) % MAX_CARVE_REQUESTS;
+            tc->quantity--;
+            tc->totalCarves++;
+        }
+
+    }
+
+    if ( changed ) {
+        // what was carved away is inside the old bounds of the chains
+        tc->regions[tc->regionTotal % CARVED_REGION_HISTORY] = region;
+        tc->regionTotal++;
+        clearSpatialQueryCache( &gw->queryService );
+    }
+
+    tc->carveTime = b2GetMilliseconds( ticks );
+
+}
+
+/**
+ * @brief Draws the carving counters.
+ */
+void drawTerrainCarverStats( const TerrainCarver *tc, int x, int y ) {
+    DrawText(
+        TextFormat(
+            "carving: %d pending, %d chains carved (%d removed, %d created) in %.3fms, %d carves, %d holes skipped (middle button: carve)",
+            tc->quantity, tc->carvedChains, tc->removedChains, tc->createdChains, tc->carveTime,
+            tc->totalCarves, tc->skippedHoles
+        ),
+        x, y, 10, DARKGRAY
+    );
+}
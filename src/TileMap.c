@@ -0,0 +1,530 @@
+/**
+ * @file TileMap.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Tile map implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "TileMap.h"
+#include "Memory.h"
+#include "Random.h"
+#include "ChainObstacle.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+// states of a tile during the collider build
+#define TILE_FREE 0
+#define TILE_USED 1
+#define TILE_VISITED 2
+
+// corner steps of the outline directions: right, down, left and up, so
+// turning right is the next one with y growing down
+static const int directionX[4] = { 1, 0, -1, 0 };
+static const int directionY[4] = { 0, 1, 0, -1 };
+
+static bool resizeTileMap( TileMap *tm, int columns, int rows ) {
+
+    if ( columns <= 0 || rows <= 0 || columns > TILE_MAP_MAX_TILES / rows ) {
+        TraceLog( LOG_WARNING, "TILEMAP: invalid size %dx%d (at most %d tiles)", columns, rows, TILE_MAP_MAX_TILES );
+        return false;
+    }
+
+    tm->columns = columns;
+    tm->rows = rows;
+    memset( tm->tiles, 0, (size_t) columns * rows );
+
+    return true;
+
+}
+
+static bool isSolidTile( const TileMap *tm, int x, int y ) {
+    return x >= 0 && y >= 0 && x < tm->columns && y < tm->rows && tm->tiles[y * tm->columns + x] != 0;
+}
+
+/**
+ * @brief Reads a text grid, one row per line: '.' and ' ' are empty,
+ * '#' is kind 1, '=' is kind 2 and the digits 1 to 9 are their kinds.
+ * Returns false if the grid is empty or too large.
+ */
+bool importTileMap( TileMap *tm, const char *text ) {
+
+    int columns = 0;
+    int rows = 0;
+    int length = 0;
+
+    for ( const char *c = text; ; c++ ) {
+        if ( *c == '\n' || *c == '\0' ) {
+            if ( length > 0 || *c == '\n' ) {
+                rows++;
+            }
+            if ( length > columns ) {
+                columns = length;
+            }
+            length = 0;
+            if ( *c == '\0' ) {
+                break;
+            }
+        } else if ( *c != '\r' ) {
+            length++;
+        }
+    }
+
+    if ( !resizeTileMap( tm, columns, rows ) ) {
+        return false;
+    }
+
+    int x = 0;
+    int y = 0;
+
+    for ( const char *c = text; *c != '\0'; c++ ) {
+        if ( *c == '\n' ) {
+            x = 0;
+            y++;
+        } else if ( *c != '\r' ) {
+            unsigned char kind = 0;
+            if ( *c == '#' ) {
+                kind = 1;
+            } else if ( *c == '=' ) {
+                kind = 2;
+            } else if ( *c >= '1' && *c <= '9' ) {
+                kind = *c - '0';
+            }
+            tm->tiles[y * columns + x] = kind;
+            x++;
+        }
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Reads a text grid file with importTileMap.
+ */
+bool loadTileMapFile( TileMap *tm, const char *fileName ) {
+
+    char *text = LoadFileText( fileName );
+    if ( text == NULL ) {
+        TraceLog( LOG_WARNING, "TILEMAP: could not read %s", fileName );
+        return false;
+    }
+
+    bool imported = importTileMap( tm, text );
+    UnloadFileText( text );
+
+    return imported;
+
+}
+
+/**
+ * @brief Generates a terrain of columns x rows tiles with caves and
+ * floating platforms. The same seed always generates the same map.
+ */
+bool generateTileMap( TileMap *tm, int columns, int rows, unsigned int seed ) {
+
+    if ( !resizeTileMap( tm, columns, rows ) ) {
+        return false;
+    }
+
+    uint32_t state = seed != 0 ? seed : 1;
+
+    // ground: grass over stone, its surface a random walk over the lower
+    // part of the map that changes in one of four columns
+    int highest = rows * 55 / 100;
+    int lowest = rows * 90 / 100;
+    int surface = ( highest + lowest ) / 2;
+
+    for ( int x = 0; x < columns; x++ ) {
+        if ( randomInt( &state, 0, 3 ) == 0 ) {
+            surface += randomInt( &state, 0, 1 ) == 0 ? -1 : 1;
+            if ( surface < highest ) {
+                surface = highest;
+            } else if ( surface > lowest ) {
+                surface = lowest;
+            }
+        }
+        for ( int y = surface; y < rows; y++ ) {
+            tm->tiles[y * columns + x] = y < surface + 2 ? 1 : 2;
+        }
+    }
+
+    // caves are carved only in the stone
+    int caves = columns * rows / 2000;
+    for ( int i = 0; i < caves; i++ ) {
+        int cx = randomInt( &state, 0, columns - 1 );
+        int cy = randomInt( &state, highest + 3, rows - 1 );
+        int rx = randomInt( &state, 2, 6 );
+        int ry = randomInt( &state, 1, 3 );
+        for ( int y = cy - ry; y <= cy + ry; y++ ) {
+            for ( int x = cx - rx; x <= cx + rx; x++ ) {
+                float dx = (float) ( x - cx ) / rx;
+                float dy = (float) ( y - cy ) / ry;
+                if ( dx * dx + dy * dy <= 1.0f && isSolidTile( tm, x, y ) && tm->tiles[y * columns + x] == 2 ) {
+                    tm->tiles[y * columns + x] = 0;
+                }
+            }
+        }
+    }
+
+    // floating platforms, some of them overlapping
+    int platforms = columns * rows / 500 + 1;
+    for ( int i = 0; i < platforms; i++ ) {
+        int width = randomInt( &state, 3, 10 );
+        int height = randomInt( &state, 1, 2 );
+        int px = randomInt( &state, 0, columns - 1 );
+        int py = randomInt( &state, rows * 10 / 100, rows * 45 / 100 );
+        for ( int y = py; y < py + height && y < rows; y++ ) {
+            for ( int x = px; x < px + width && x < columns; x++ ) {
+                tm->tiles[y * columns + x] = 3;
+            }
+        }
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Empties the tiles that overlap area, in world coordinates.
+ */
+void clearTileMapArea( TileMap *tm, Rectangle area ) {
+
+    int x0 = (int) floorf( ( area.x - tm->origin.x ) / tm->tileSize );
+    int y0 = (int) floorf( ( area.y - tm->origin.y ) / tm->tileSize );
+    int x1 = (int) ceilf( ( area.x + area.width - tm->origin.x ) / tm->tileSize );
+    int y1 = (int) ceilf( ( area.y + area.height - tm->origin.y ) / tm->tileSize );
+
+    for ( int y = y0 < 0 ? 0 : y0; y < y1 && y < tm->rows; y++ ) {
+        for ( int x = x0 < 0 ? 0 : x0; x < x1 && x < tm->columns; x++ ) {
+            tm->tiles[y * tm->columns + x] = 0;
+        }
+    }
+
+}
+
+static bool fitsTileRectangle( const TileMap *tm, TileRect area, const unsigned char *used, int x, int y, bool byKind, unsigned char kind ) {
+    unsigned char tile = tm->tiles[( area.y + y ) * tm->columns + area.x + x];
+    return tile != 0 && used[y * area.width + x] == TILE_FREE && ( !byKind || tile == kind );
+}
+
+/**
+ * @brief Greedy merge step: finds the next maximal rectangle of solid
+ * tiles not yet marked in used, scanning area row by row from *cursor,
+ * and marks its tiles. used holds one byte per tile of area and starts
+ * zeroed, as does *cursor. With byKind set, a rectangle only has tiles
+ * of one kind. Returns false when every solid tile is used.
+ */
+bool findNextTileRectangle( const TileMap *tm, TileRect area, bool byKind, unsigned char *used, int *cursor, TileRect *rect ) {
+
+    int count = area.width * area.height;
+
+    for ( ; *cursor < count; ( *cursor )++ ) {
+
+        int x = *cursor % area.width;
+        int y = *cursor / area.width;
+        unsigned char kind = tm->tiles[( area.y + y ) * tm->columns + area.x + x];
+
+        if ( kind == 0 || used[*cursor] != TILE_FREE ) {
+            continue;
+        }
+
+        // as wide as possible, then as tall as the whole width allows
+        int width = 1;
+        while ( x + width < area.width && fitsTileRectangle( tm, area, used, x + width, y, byKind, kind ) ) {
+            width++;
+        }
+
+        int height = 1;
+        while ( y + height < area.height ) {
+            bool fits = true;
+            for ( int i = x; i < x + width && fits; i++ ) {
+                fits = fitsTileRectangle( tm, area, used, i, y + height, byKind, kind );
+            }
+            if ( !fits ) {
+                break;
+            }
+            height++;
+        }
+
+        for ( int j = y; j < y + height; j++ ) {
+            memset( &used[j * area.width + x], TILE_USED, width );
+        }
+
+        *rect = (TileRect){ area.x + x, area.y + y, width, height, kind };
+        ( *cursor )++;
+
+        return true;
+
+    }
+
+    return false;
+
+}
+
+/**
+ * @brief Walks the outer outline of the region whose first tile in scan
+ * order is (x, y), keeping the solid tiles on the right, and writes its
+ * corners in world coordinates, clockwise on the screen. Returns the
+ * quantity of outline edges, in tiles; *cornerQuantity is -1 if there
+ * were more than maxCorners corners.
+ */
+static int traceTileRegionOutline( const TileMap *tm, int x, int y, b2Vec2 *corners, int maxCorners, int *cornerQuantity ) {
+
+    // the top edge of the first tile is on the outline, and its top left
+    // corner is a corner of it, reached going up
+    int cx = x;
+    int cy = y;
+    int direction = 0;
+    int edges = 0;
+    *cornerQuantity = 0;
+
+    do {
+
+        cx += directionX[direction];
+        cy += directionY[direction];
+        edges++;
+
+        // tiles ahead of the corner, to the left and to the right
+        int lx;
+        int ly;
+        int rx;
+        int ry;
+
+        switch ( direction ) {
+            case 0: lx = cx; ly = cy - 1; rx = cx; ry = cy; break;
+            case 1: lx = cx; ly = cy; rx = cx - 1; ry = cy; break;
+            case 2: lx = cx - 1; ly = cy; rx = cx - 1; ry = cy - 1; break;
+            default: lx = cx - 1; ly = cy - 1; rx = cx; ry = cy - 1; break;
+        }
+
+        int next = direction;
+        if ( !isSolidTile( tm, rx, ry ) ) {
+            next = ( direction + 1 ) % 4;
+        } else if ( isSolidTile( tm, lx, ly ) ) {
+            next = ( direction + 3 ) % 4;
+        }
+
+        if ( next != direction && *cornerQuantity >= 0 ) {
+            if ( *cornerQuantity < maxCorners ) {
+                corners[( *cornerQuantity )++] = (b2Vec2){ tm->origin.x + cx * tm->tileSize, tm->origin.y + cy * tm->tileSize };
+            } else {
+                *cornerQuantity = -1;
+            }
+        }
+
+        direction = next;
+
+    } while ( cx != x || cy != y || direction != 0 );
+
+    return edges;
+
+}
+
+/**
+ * @brief Creates a chain obstacle for each region of solid tiles whose
+ * outline fits into one, marking its tiles as used. Regions with holes
+ * or too many corners are left for the rectangles.
+ */
+static void createTileMapChains( TileMap *tm, unsigned char *used, GameWorld *gw ) {
+
+    int count = tm->columns * tm->rows;
+    int *region = (int*) allocMemory( MEMORY_SUBSYSTEM_WORLD, sizeof( int ) * count );
+    b2Vec2 corners[MAX_CHAIN_OBSTACLE_POINTS];
+
+    for ( int start = 0; start < count && gw->chainObstacleQuantity < MAX_CHAIN_OBSTACLES; start++ ) {
+
+        if ( tm->tiles[start] == 0 || used[start] != TILE_FREE ) {
+            continue;
+        }
+
+        // flood fill of the 4 connected region, counting the tile sides
+        // that face empty tiles, which are all in its outlines
+        int tileQuantity = 1;
+        int outlineEdges = 0;
+        region[0] = start;
+        used[start] = TILE_VISITED;
+
+        for ( int i = 0; i < tileQuantity; i++ ) {
+            int x = region[i] % tm->columns;
+            int y = region[i] / tm->columns;
+            for ( int d = 0; d < 4; d++ ) {
+                int nx = x + directionX[d];
+                int ny = y + directionY[d];
+                if ( !isSolidTile( tm, nx, ny ) ) {
+                    outlineEdges++;
+                } else if ( used[ny * tm->columns + nx] == TILE_FREE ) {
+                    used[ny * tm->columns + nx] = TILE_VISITED;
+                    region[tileQuantity++] = ny * tm->columns + nx;
+                }
+            }
+        }
+
+        int cornerQuantity;
+        int edges = traceTileRegionOutline( tm, start % tm->columns, start / tm->columns, corners, MAX_CHAIN_OBSTACLE_POINTS - 1, &cornerQuantity );
+
+        // an outer outline shorter than the region outlines means holes
+        if ( edges == outlineEdges && cornerQuantity >= 4 ) {
+            int before = gw->chainObstacleQuantity;
+            createChainObstacle( corners, cornerQuantity, ORANGE, cornerQuantity > 4, SHAPE_FLAG_NONE, gw );
+            if ( gw->chainObstacleQuantity > before ) {
+                tm->chainQuantity += gw->chainObstacleQuantity - before;
+                for ( int i = 0; i < tileQuantity; i++ ) {
+                    used[region[i]] = TILE_USED;
+                }
+            }
+        }
+
+    }
+
+    // the visited regions go to the rectangles
+    for ( int i = 0; i < count; i++ ) {
+        if ( used[i] == TILE_VISITED ) {
+            used[i] = TILE_FREE;
+        }
+    }
+
+    freeMemory( region );
+
+}
+
+/**
+ * @brief Imports or generates the tile map of a level into the world,
+ * fitting it into the walls, and creates its colliders.
+ */
+bool loadTileMap( GameWorld *gw, const TileMapConfig *config ) {
+
+    uint64_t ticks = b2GetTicks();
+    TileMap *tm = &gw->tileMap;
+
+    bool created = config->fileName != NULL ?
+        loadTileMapFile( tm, config->fileName ) :
+        generateTileMap( tm, config->columns, config->rows, config->seed );
+
+    if ( !created ) {
+        return false;
+    }
+
+    float width = gw->width - TILE_MAP_WALL_MARGIN * 2;
+    float height = gw->height - TILE_MAP_WALL_MARGIN * 2;
+
+    tm->type = ENTITY_TYPE_TILE_MAP;
+    tm->origin = (b2Vec2){ TILE_MAP_WALL_MARGIN, TILE_MAP_WALL_MARGIN };
+    tm->tileSize = config->tileSize > 0.0f ? config->tileSize : fminf( width / tm->columns, height / tm->rows );
+    tm->rectangleQuantity = 0;
+    tm->chainQuantity = 0;
+
+    // the player starts inside the map area
+    Player *p = &gw->player;
+    clearTileMapArea( tm, (Rectangle){ p->position.x - p->dim.x, p->position.y - p->dim.y, p->dim.x * 2, p->dim.y * 2 } );
+
+    int count = tm->columns * tm->rows;
+    tm->solidTiles = 0;
+    for ( int i = 0; i < count; i++ ) {
+        tm->solidTiles += tm->tiles[i] != 0;
+    }
+
+    unsigned char *used = (unsigned char*) allocMemory( MEMORY_SUBSYSTEM_WORLD, count );
+    memset( used, TILE_FREE, count );
+
+    if ( config->outlineChains && tm->tileSize >= TILE_MAP_MIN_CHAIN_TILE_SIZE ) {
+        createTileMapChains( tm, used, gw );
+    }
+
+    // every other solid tile goes into a box of a single static body,
+    // one shape per merged rectangle
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_staticBody;
+    bodyDef.userData = tm;
+    tm->bodyId = b2CreateBody( gw->worldId, &bodyDef );
+
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    TileRect area = { 0, 0, tm->columns, tm->rows, 0 };
+    TileRect rect;
+    int cursor = 0;
+
+    while ( findNextTileRectangle( tm, area, false, used, &cursor, &rect ) ) {
+        b2Vec2 center = {
+            tm->origin.x + ( rect.x + rect.width * 0.5f ) * tm->tileSize,
+            tm->origin.y + ( rect.y + rect.height * 0.5f ) * tm->tileSize
+        };
+        b2Polygon box = b2MakeOffsetBox( rect.width * tm->tileSize * 0.5f, rect.height * tm->tileSize * 0.5f, center, b2Rot_identity );
+        b2CreatePolygonShape( tm->bodyId, &shapeDef, &box );
+        tm->rectangleQuantity++;
+    }
+
+    freeMemory( used );
+
+    tm->loaded = true;
+    tm->revision++;
+    tm->buildTime = b2GetMilliseconds( ticks );
+    gw->staticRevision++;
+
+    TraceLog(
+        LOG_INFO, "TILEMAP: %dx%d tiles, %d solid, merged into %d rectangles and %d chains in %.3fms",
+        tm->columns, tm->rows, tm->solidTiles, tm->rectangleQuantity, tm->chainQuantity, tm->buildTime
+    );
+
+    return true;
+
+}
+
+/**
+ * @brief Destroys the colliders of the tile map of the world.
+ */
+void unloadTileMap( GameWorld *gw ) {
+
+    TileMap *tm = &gw->tileMap;
+
+    if ( tm->loaded ) {
+        b2DestroyBody( tm->bodyId );
+        tm->loaded = false;
+        tm->revision++;
+    }
+
+}
+
+/**
+ * @brief Copies the tile map into a snapshot. The tiles are only copied
+ * when they changed since the last copy or force is set.
+ */
+void copyTileMap( TileMap *dst, const TileMap *src, bool force ) {
+
+    if ( src->loaded && ( force || dst->revision != src->revision ) ) {
+        memcpy( dst->tiles, src->tiles, (size_t) src->columns * src->rows );
+    }
+
+    dst->type = src->type;
+    dst->bodyId = src->bodyId;
+    dst->origin = src->origin;
+    dst->tileSize = src->tileSize;
+    dst->columns = src->columns;
+    dst->rows = src->rows;
+    dst->loaded = src->loaded;
+    dst->revision = src->revision;
+    dst->solidTiles = src->solidTiles;
+    dst->rectangleQuantity = src->rectangleQuantity;
+    dst->chainQuantity = src->chainQuantity;
+    dst->buildTime = src->buildTime;
+
+}
+
+/**
+ * @brief Returns the color of a tile kind.
+ */
+Color getTileColor( unsigned char kind ) {
+    switch ( kind ) {
+        case 1: return DARKGREEN;
+        case 2: return GRAY;
+        case 3: return BROWN;
+        default: return DARKGRAY;
+    }
+}
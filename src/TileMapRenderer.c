@@ -0,0 +1,311 @@
+/**
+ * @file TileMapRenderer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Chunked tile map renderer implementation.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "TileMapRenderer.h"
+#include "TileMap.h"
+#include "GeometryBuffer.h"
+#include "Memory.h"
+#include "Types.h"
+
+#include "raylib/raylib.h"
+#include "raylib/rlgl.h"
+#define RAYMATH_STATIC_INLINE
+#include "raylib/raymath.h"
+
+// worst case of a chunk: every tile in its own rectangle
+#define TILE_MAP_CHUNK_MAX_VERTICES ( TILE_MAP_CHUNK_SIZE * TILE_MAP_CHUNK_SIZE * 6 )
+
+static const char *vertexShaderCode =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in vec4 vertexColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp * vec4( vertexPosition, 0.0, 1.0 );\n"
+    "}\n";
+
+static const char *fragmentShaderCode =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+static TileRect chunkArea( const TileMap *tm, int column, int row ) {
+
+    int x = column * TILE_MAP_CHUNK_SIZE;
+    int y = row * TILE_MAP_CHUNK_SIZE;
+
+    return (TileRect){
+        x, y,
+        tm->columns - x < TILE_MAP_CHUNK_SIZE ? tm->columns - x : TILE_MAP_CHUNK_SIZE,
+        tm->rows - y < TILE_MAP_CHUNK_SIZE ? tm->rows - y : TILE_MAP_CHUNK_SIZE,
+        0
+    };
+
+}
+
+static Rectangle tileRectBounds( const TileMap *tm, TileRect r ) {
+    return (Rectangle){
+        tm->origin.x + r.x * tm->tileSize, tm->origin.y + r.y * tm->tileSize,
+        r.width * tm->tileSize, r.height * tm->tileSize
+    };
+}
+
+static void unloadChunks( TileMapRenderer *tmr ) {
+
+    for ( int i = 0; i < tmr->columns * tmr->rows; i++ ) {
+        TileMapChunk *c = &tmr->chunks[i];
+        if ( c->vaoId != 0 ) {
+            rlUnloadVertexBuffer( c->vboId );
+            rlUnloadVertexArray( c->vaoId );
+        }
+        c->vaoId = 0;
+        c->vboId = 0;
+        c->vertexQuantity = 0;
+    }
+
+    tmr->columns = 0;
+    tmr->rows = 0;
+
+}
+
+static int buildChunkVertices( const TileMap *tm, TileRect area, GeometryVertex *vertices ) {
+
+    unsigned char used[TILE_MAP_CHUNK_SIZE * TILE_MAP_CHUNK_SIZE] = { 0 };
+    TileRect rect;
+    int cursor = 0;
+    int quantity = 0;
+
+    while ( findNextTileRectangle( tm, area, true, used, &cursor, &rect ) ) {
+
+        Rectangle b = tileRectBounds( tm, rect );
+        Color c = getTileColor( rect.kind );
+        // counter clockwise on the screen, raylib culls the back faces
+        float x[6] = { b.x, b.x, b.x + b.width, b.x, b.x + b.width, b.x + b.width };
+        float y[6] = { b.y, b.y + b.height, b.y + b.height, b.y, b.y + b.height, b.y };
+
+        for ( int i = 0; i < 6; i++ ) {
+            vertices[quantity++] = (GeometryVertex){ x[i], y[i], { c.r, c.g, c.b, c.a } };
+        }
+
+    }
+
+    return quantity;
+
+}
+
+static void buildChunks( TileMapRenderer *tmr, const TileMap *tm ) {
+
+    unloadChunks( tmr );
+
+    int columns = ( tm->columns + TILE_MAP_CHUNK_SIZE - 1 ) / TILE_MAP_CHUNK_SIZE;
+    int rows = ( tm->rows + TILE_MAP_CHUNK_SIZE - 1 ) / TILE_MAP_CHUNK_SIZE;
+
+    if ( columns * rows > tmr->chunkCapacity ) {
+        freeMemory( tmr->chunks );
+        tmr->chunkCapacity = columns * rows;
+        tmr->chunks = (TileMapChunk*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( TileMapChunk ) * tmr->chunkCapacity );
+        memset( tmr->chunks, 0, sizeof( TileMapChunk ) * tmr->chunkCapacity );
+    }
+
+    tmr->columns = columns;
+    tmr->rows = rows;
+    tmr->builtVertices = 0;
+
+    size_t mark = getFrameScratchMark();
+    GeometryVertex *vertices = NULL;
+    bool scratch = false;
+
+    if ( tmr->ready ) {
+        vertices = (GeometryVertex*) allocFrameScratch( sizeof( GeometryVertex ) * TILE_MAP_CHUNK_MAX_VERTICES );
+        scratch = vertices != NULL;
+        if ( !scratch ) {
+            vertices = (GeometryVertex*) allocMemory( MEMORY_SUBSYSTEM_SCRATCH, sizeof( GeometryVertex ) * TILE_MAP_CHUNK_MAX_VERTICES );
+        }
+    }
+
+    for ( int r = 0; r < rows; r++ ) {
+        for ( int c = 0; c < columns; c++ ) {
+
+            TileMapChunk *chunk = &tmr->chunks[r * columns + c];
+            TileRect area = chunkArea( tm, c, r );
+            chunk->bounds = tileRectBounds( tm, area );
+
+            if ( vertices == NULL ) {
+                continue;
+            }
+
+            chunk->vertexQuantity = buildChunkVertices( tm, area, vertices );
+            if ( chunk->vertexQuantity == 0 ) {
+                continue;
+            }
+
+            chunk->vaoId = rlLoadVertexArray();
+            rlEnableVertexArray( chunk->vaoId );
+            chunk->vboId = rlLoadVertexBuffer( vertices, sizeof( GeometryVertex ) * chunk->vertexQuantity, false );
+            rlSetVertexAttribute( tmr->positionLoc, 2, RL_FLOAT, false, sizeof( GeometryVertex ), offsetof( GeometryVertex, x ) );
+            rlEnableVertexAttribute( tmr->positionLoc );
+            rlSetVertexAttribute( tmr->colorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof( GeometryVertex ), offsetof( GeometryVertex, color ) );
+            rlEnableVertexAttribute( tmr->colorLoc );
+            rlDisableVertexArray();
+
+            tmr->builtVertices += chunk->vertexQuantity;
+
+        }
+    }
+
+    if ( scratch ) {
+        releaseFrameScratch( mark );
+    } else {
+        freeMemory( vertices );
+    }
+
+    tmr->rebuilds++;
+
+}
+
+/**
+ * @brief Creates a dinamically allocated TileMapRenderer struct instance.
+ * Needs an OpenGL context.
+ */
+TileMapRenderer* createTileMapRenderer( void ) {
+
+    TileMapRenderer *tmr = (TileMapRenderer*) allocMemory( MEMORY_SUBSYSTEM_RENDER, sizeof( TileMapRenderer ) );
+
+    tmr->chunks = NULL;
+    tmr->chunkCapacity = 0;
+    tmr->columns = 0;
+    tmr->rows = 0;
+    tmr->revision = 0;
+    tmr->valid = false;
+    tmr->drawnChunks = 0;
+    tmr->culledChunks = 0;
+    tmr->drawnVertices = 0;
+    tmr->builtVertices = 0;
+    tmr->rebuilds = 0;
+
+    tmr->shaderId = rlLoadShaderCode( vertexShaderCode, fragmentShaderCode );
+    tmr->ready = tmr->shaderId != 0 && tmr->shaderId != rlGetShaderIdDefault();
+
+    if ( !tmr->ready ) {
+        TraceLog( LOG_WARNING, "TILEMAP: shader not available, using immediate mode" );
+        return tmr;
+    }
+
+    tmr->mvpLoc = rlGetLocationUniform( tmr->shaderId, "mvp" );
+    tmr->positionLoc = rlGetLocationAttrib( tmr->shaderId, "vertexPosition" );
+    tmr->colorLoc = rlGetLocationAttrib( tmr->shaderId, "vertexColor" );
+
+    return tmr;
+
+}
+
+/**
+ * @brief Destroys a TileMapRenderer object and its GPU resources.
+ */
+void destroyTileMapRenderer( TileMapRenderer *tmr ) {
+
+    unloadChunks( tmr );
+
+    if ( tmr->ready ) {
+        rlUnloadShaderProgram( tmr->shaderId );
+    }
+
+    freeMemory( tmr->chunks );
+    freeMemory( tmr );
+
+}
+
+/**
+ * @brief Rebuilds the chunk meshes when the tiles changed.
+ */
+void updateTileMapRenderer( TileMapRenderer *tmr, const TileMap *tm ) {
+
+    if ( tmr->valid && tmr->revision == tm->revision ) {
+        return;
+    }
+
+    if ( tm->loaded ) {
+        buildChunks( tmr, tm );
+    } else {
+        unloadChunks( tmr );
+    }
+
+    tmr->revision = tm->revision;
+    tmr->valid = true;
+
+}
+
+/**
+ * @brief Draws the chunks that are on the screen.
+ */
+void drawTileMapRenderer( TileMapRenderer *tmr, const TileMap *tm ) {
+
+    tmr->drawnChunks = 0;
+    tmr->culledChunks = 0;
+    tmr->drawnVertices = 0;
+
+    if ( !tm->loaded || tmr->columns * tmr->rows == 0 ) {
+        return;
+    }
+
+    Rectangle screen = { 0, 0, GetScreenWidth(), GetScreenHeight() };
+
+    if ( tmr->ready ) {
+        // keeps the order with what was drawn through raylib before
+        rlDrawRenderBatchActive();
+        rlEnableShader( tmr->shaderId );
+        rlSetUniformMatrix( tmr->mvpLoc, MatrixMultiply( rlGetMatrixModelview(), rlGetMatrixProjection() ) );
+    }
+
+    for ( int r = 0; r < tmr->rows; r++ ) {
+        for ( int c = 0; c < tmr->columns; c++ ) {
+
+            TileMapChunk *chunk = &tmr->chunks[r * tmr->columns + c];
+
+            if ( !CheckCollisionRecs( chunk->bounds, screen ) ) {
+                tmr->culledChunks++;
+                continue;
+            }
+
+            if ( tmr->ready ) {
+                if ( chunk->vertexQuantity > 0 ) {
+                    rlEnableVertexArray( chunk->vaoId );
+                    rlDrawVertexArray( 0, chunk->vertexQuantity );
+                    tmr->drawnVertices += chunk->vertexQuantity;
+                }
+            } else {
+                // without the shader the rectangles are merged every frame
+                unsigned char used[TILE_MAP_CHUNK_SIZE * TILE_MAP_CHUNK_SIZE] = { 0 };
+                TileRect rect;
+                int cursor = 0;
+                while ( findNextTileRectangle( tm, chunkArea( tm, c, r ), true, used, &cursor, &rect ) ) {
+                    DrawRectangleRec( tileRectBounds( tm, rect ), getTileColor( rect.kind ) );
+                    tmr->drawnVertices += 6;
+                }
+            }
+
+            tmr->drawnChunks++;
+
+        }
+    }
+
+    if ( tmr->ready ) {
+        rlDisableVertexArray();
+        rlDisableShader();
+    }
+
+}
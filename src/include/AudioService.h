@@ -0,0 +1,155 @@
+/**
+ * @file AudioService.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Music streaming service struct and function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "raylib/raylib.h"
+
+// must be a power of two
+#define AUDIO_SERVICE_QUEUE_SIZE 64
+
+#define AUDIO_SERVICE_MAX_PATH 256
+
+// frames of each of the two buffers of a music stream, a larger buffer
+// survives longer stalls of the audio thread
+#define AUDIO_SERVICE_BUFFER_FRAMES 4096
+
+// seconds between two refills of the audio thread
+#define AUDIO_SERVICE_PERIOD 0.005f
+
+typedef enum AudioCommandType {
+    AUDIO_COMMAND_PLAY,
+    AUDIO_COMMAND_STOP,
+    AUDIO_COMMAND_CROSSFADE,
+    AUDIO_COMMAND_VOLUME
+} AudioCommandType;
+
+typedef struct AudioCommand {
+    AudioCommandType type;
+    char fileName[AUDIO_SERVICE_MAX_PATH];
+    float value;
+} AudioCommand;
+
+typedef enum AudioEventType {
+    AUDIO_EVENT_STARTED,
+    AUDIO_EVENT_LOAD_FAILED,
+    AUDIO_EVENT_STOPPED
+} AudioEventType;
+
+typedef struct AudioEvent {
+    AudioEventType type;
+    char fileName[AUDIO_SERVICE_MAX_PATH];
+} AudioEvent;
+
+/**
+ * @brief Single producer, single consumer ring of commands. The producer
+ * only writes tail and the consumer only writes head, so neither waits
+ * for the other.
+ */
+typedef struct AudioCommandQueue {
+    AudioCommand commands[AUDIO_SERVICE_QUEUE_SIZE];
+    atomic_int head;
+    atomic_int tail;
+} AudioCommandQueue;
+
+typedef struct AudioEventQueue {
+    AudioEvent events[AUDIO_SERVICE_QUEUE_SIZE];
+    atomic_int head;
+    atomic_int tail;
+} AudioEventQueue;
+
+/**
+ * @brief A music stream of the audio thread, fading to targetVolume.
+ */
+typedef struct MusicVoice {
+    Music music;
+    char fileName[AUDIO_SERVICE_MAX_PATH];
+    bool active;
+    float volume;
+    float targetVolume;
+    float fadeSpeed;
+} MusicVoice;
+
+/**
+ * @brief Streams music on its own thread, so decoding and refilling the
+ * buffers don't depend on the frames of the game loop. The game talks to
+ * it only through lock free queues: commands go in, events come out.
+ * Two voices allow crossfading between tracks.
+ */
+typedef struct AudioService {
+
+    pthread_t thread;
+    atomic_bool running;
+
+    AudioCommandQueue commands;
+    AudioEventQueue events;
+
+    // owned by the audio thread
+    MusicVoice voices[2];
+    float masterVolume;
+    double lastRefill;
+
+    // written by the audio thread, read by anyone
+    atomic_int refills;
+    atomic_int underruns;
+    atomic_int processedCommands;
+    atomic_int maxGapMicroseconds;
+
+    // owned by the game thread
+    int droppedCommands;
+    char nowPlaying[AUDIO_SERVICE_MAX_PATH];
+
+} AudioService;
+
+/**
+ * @brief Creates a dinamically allocated AudioService struct instance
+ * and starts its thread. Needs an initialized audio device. Returns
+ * NULL if the thread can't be started.
+ */
+AudioService* createAudioService( void );
+
+/**
+ * @brief Stops the thread and destroys an AudioService object and its
+ * music streams.
+ */
+void destroyAudioService( AudioService *as );
+
+/**
+ * @brief Starts a track, replacing what is playing. Returns false if the
+ * command queue is full.
+ */
+bool playAudioServiceMusic( AudioService *as, const char *fileName );
+
+/**
+ * @brief Fades out and stops the music.
+ */
+bool stopAudioServiceMusic( AudioService *as, float seconds );
+
+/**
+ * @brief Fades from what is playing to a new track.
+ */
+bool crossfadeAudioServiceMusic( AudioService *as, const char *fileName, float seconds );
+
+/**
+ * @brief Sets the volume of the music, from 0 to 1.
+ */
+bool setAudioServiceVolume( AudioService *as, float volume );
+
+/**
+ * @brief Consumes the events of the audio thread. Called once per frame
+ * by the game thread.
+ */
+void updateAudioService( AudioService *as );
+
+/**
+ * @brief Draws the streaming counters.
+ */
+void drawAudioServiceStats( AudioService *as, int x, int y );
@@ -2,5 +2,33 @@
 
 #include "Types.h"
 
-void createChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, GameWorld *gw );
-void drawChainObstacle( ChainObstacle *co );
\ No newline at end of file
+// vertex cleanup before the chain is created, in length units
+#define CHAIN_OBSTACLE_WELD_TOLERANCE 2.0f
+#define CHAIN_OBSTACLE_COLLINEAR_TOLERANCE 0.5f
+#define CHAIN_OBSTACLE_SIMPLIFY_TOLERANCE 1.5f
+
+// self intersecting outlines are split in simple loops, or ignored
+#define CHAIN_OBSTACLE_SPLIT_SELF_INTERSECTIONS true
+
+/**
+ * @brief Creates the chain obstacles of an outline. flags are ShapeFlag
+ * bits, shared by every shape of the obstacles.
+ */
+void createChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, unsigned int flags, GameWorld *gw );
+
+/**
+ * @brief Creates the chain obstacles of an outline without incrementing
+ * the static revision, for callers that invalidate what they changed.
+ * Returns how many chain obstacles were created.
+ */
+int addChainObstacle( b2Vec2 *points, int pointQuantity, Color color, bool isConcave, unsigned int flags, GameWorld *gw );
+
+/**
+ * @brief Destroys a chain obstacle and moves the last one into its slot,
+ * so the slots and their vertex storage are reused. Doesn't increment
+ * the static revision.
+ */
+void removeChainObstacle( int index, GameWorld *gw );
+
+void drawChainObstacle( ChainObstacle *co );
+void drawChainObstacleLabels( ChainObstacle *co );
\ No newline at end of file
@@ -10,10 +10,55 @@
 #include "raylib/raylib.h"
 #include "box2d/box2d.h"
 
+#include "GeometryBuffer.h"
+
+typedef struct TriangleB2Vec2 {
+    b2Vec2 a;
+    b2Vec2 b;
+    b2Vec2 c;
+} TriangleB2Vec2;
+
+typedef enum ConcaveFillMode {
+    CONCAVE_FILL_TRIANGULATE,
+    CONCAVE_FILL_STENCIL
+} ConcaveFillMode;
+
 void drawShape( const Vector2 *points, int pointCount, Color color, bool cw );
 void drawConcaveShape( const Vector2 *points, int pointCount, Color color, bool cw );
 void drawShapeLines( const Vector2 *points, int pointCount, Color color );
 
+/**
+ * @brief Makes the B2Vec2 shape functions write into gb instead of
+ * drawing immediately through rlgl. NULL restores the immediate mode.
+ */
+void setDrawingGeometryBuffer( GeometryBuffer *gb );
+
+/**
+ * @brief Selects how drawConcaveShapeB2Vec2 fills: CPU ear clipping or
+ * stencil then cover on the GPU. The stencil mode needs a stencil buffer
+ * in the current framebuffer, cleared with clearStencilBuffer.
+ */
+void setConcaveFillMode( ConcaveFillMode mode );
+void clearStencilBuffer( void );
+
+bool isConvexB2Vec2( b2Vec2 prev, b2Vec2 curr, b2Vec2 next );
+bool isTriangleCCWB2Vec2( b2Vec2 a, b2Vec2 b, b2Vec2 c );
+bool isTriangleCWB2Vec2( b2Vec2 a, b2Vec2 b, b2Vec2 c );
+bool CheckCollisionPointTriangleB2Vec2( b2Vec2 point, b2Vec2 a, b2Vec2 b, b2Vec2 c );
+
+/**
+ * @brief Ear clipping triangulation of a simple polygon. Writes at most
+ * maxTriangles triangles and returns how many were written.
+ */
+int triangulatePolygonB2Vec2( const b2Vec2 *points, int pointCount, TriangleB2Vec2 *triangles, int maxTriangles, bool cw );
+
+/**
+ * @brief Writes the centroid fan of a shape, pointCount triangles, into
+ * vertices. Returns the quantity of vertices written.
+ */
+int writeShapeFanB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw, GeometryVertex *vertices );
+
 void drawShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw );
 void drawConcaveShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color, bool cw );
-void drawShapeLinesB2Vec2( const b2Vec2 *points, int pointCount, Color color );
\ No newline at end of file
+void drawShapeLinesB2Vec2( const b2Vec2 *points, int pointCount, Color color );
+void drawStencilShapeB2Vec2( const b2Vec2 *points, int pointCount, Color color );
\ No newline at end of file
@@ -0,0 +1,24 @@
+/**
+ * @file GameInput.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GameInput function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+/**
+ * @brief Reads the current keyboard and mouse state. Must be called from
+ * the thread that owns the window.
+ */
+GameInput readGameInput( void );
+
+/**
+ * @brief Accumulates src into dst: held keys and mouse position are
+ * replaced and one-shot events are kept until consumed.
+ */
+void mergeGameInput( GameInput *dst, const GameInput *src );
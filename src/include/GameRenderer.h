@@ -0,0 +1,103 @@
+/**
+ * @file GameRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GameRenderer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "InstancedRenderer.h"
+#include "LabelCache.h"
+#include "GeometryBuffer.h"
+#include "StaticLayer.h"
+#include "TileMapRenderer.h"
+#include "RenderScaler.h"
+#include "GpuTimer.h"
+#include "ParticleSystem.h"
+#include "ImpactAudio.h"
+#include "AudioService.h"
+
+typedef enum AntialiasingMode {
+    ANTIALIASING_NONE,
+    ANTIALIASING_MSAA_4X,
+    ANTIALIASING_FXAA
+} AntialiasingMode;
+
+/**
+ * @brief Render side state used to draw the snapshots: GPU resources and
+ * render options. Lives in the thread that owns the window.
+ */
+typedef struct GameRenderer {
+
+    InstancedRenderer *boxRenderer;
+    bool instancing;
+
+    LabelCache *labelCache;
+    bool showLabels;
+
+    GeometryBuffer *geometryBuffer;
+    bool streamGeometry;
+
+    // concave chains filled with stencil then cover instead of ear clipping
+    bool stencilFill;
+
+    // walls and chain obstacles drawn from cached render texture tiles
+    StaticLayer *staticLayer;
+    bool cacheStaticLayer;
+
+    // tile map drawn from meshes cached per chunk
+    TileMapRenderer *tileMapRenderer;
+
+    // effects spawned from the bursts of the snapshots
+    ParticleSystem *particles;
+
+    // owned by the window, only its counters are drawn (NULL for none)
+    ImpactAudio *impactAudio;
+    AudioService *audioService;
+
+    // internal resolution of the scene
+    RenderScaler *scaler;
+
+    // MSAA needs a multisampled window, FXAA is a pass over the scene
+    // target; the GPU time of the frames is measured to compare them.
+    // The scene target is not multisampled, so MSAA only works at full
+    // scale, below it the scene has no anti-aliasing
+    AntialiasingMode antialiasing;
+    bool msaaAvailable;
+    GpuTimer *gpuTimer;
+
+    // CPU milliseconds of the last drawGameWorld, without the buffer swap
+    double drawTime;
+
+} GameRenderer;
+
+/**
+ * @brief Creates a dinamically allocated GameRenderer struct instance.
+ * Needs an OpenGL context.
+ */
+GameRenderer* createGameRenderer( void );
+
+/**
+ * @brief Selects the anti-aliasing mode. MSAA falls back to none when the
+ * window was not created multisampled.
+ */
+void setGameRendererAntialiasing( GameRenderer *gr, AntialiasingMode mode );
+
+/**
+ * @brief Returns the anti-aliasing mode the scene is actually drawn
+ * with: MSAA is lost when the scene goes to the scaled target.
+ */
+AntialiasingMode getGameRendererEffectiveAntialiasing( const GameRenderer *gr );
+
+/**
+ * @brief Returns the name of an anti-aliasing mode.
+ */
+const char *getAntialiasingModeName( AntialiasingMode mode );
+
+/**
+ * @brief Destroys a GameRenderer object and its GPU resources.
+ */
+void destroyGameRenderer( GameRenderer *gr );
@@ -10,6 +10,11 @@
 #include <stdbool.h>
 
 #include "GameWorld.h"
+#include "RenderPipeline.h"
+#include "GameRenderer.h"
+#include "StressScene.h"
+#include "ImpactAudio.h"
+#include "AudioService.h"
 
 typedef struct GameWindow {
 
@@ -29,6 +34,44 @@ typedef struct GameWindow {
 
     GameWorld *gw;
 
+    // when pipelined, the simulation of the next frame runs in its own
+    // thread while the current one is drawn (toggled with F5)
+    bool pipelined;
+    RenderPipeline *pipeline;
+    RenderSnapshot *snapshot;
+
+    GameRenderer *renderer;
+
+    // hits of the snapshots played through a bounded pool of voices
+    ImpactAudio *impactAudio;
+
+    // music streamed by its own thread, so stalls of the game loop don't
+    // starve it (NULL without an audio device), and the track started
+    // with the window (NULL for none, toggled with M)
+    AudioService *audioService;
+    const char *musicFileName;
+    bool musicPlaying;
+
+    // internal resolution of the scene, upscaled to the window, and if
+    // it follows the frame time budget (cycled with F11)
+    float renderScale;
+    bool dynamicRenderScale;
+
+    // antialiasing requests a multisampled window, this selects what is
+    // used: none, MSAA (if multisampled) or FXAA (cycled with TAB)
+    AntialiasingMode antialiasingMode;
+
+    // generated scene added to the world and the CSV file that receives
+    // its timings when the window is closed (NULL for none)
+    bool useStressScene;
+    StressSceneConfig stressScene;
+    const char *stressReportFileName;
+    StressReport stressReport;
+
+    // tile map level, loaded at start when requested
+    bool useTileMap;
+    TileMapConfig tileMap;
+
     bool initialized;
 
 } GameWindow;
@@ -56,6 +99,43 @@ GameWindow* createGameWindow(
  */
 void initGameWindow( GameWindow *gameWindow );
 
+/**
+ * @brief Switches between serial and pipelined simulation/rendering.
+ */
+void setGameWindowPipelined( GameWindow *gameWindow, bool pipelined );
+
+/**
+ * @brief Sets the internal resolution scale of the scene, from 0.5 to 1.
+ * When dynamic, the scale starts there and follows the frame time
+ * budget of the target FPS.
+ */
+void setGameWindowRenderScale( GameWindow *gameWindow, float scale, bool dynamic );
+
+/**
+ * @brief Selects the anti-aliasing mode. MSAA is only available if the
+ * window was created with antialiasing.
+ */
+void setGameWindowAntialiasingMode( GameWindow *gameWindow, AntialiasingMode mode );
+
+/**
+ * @brief Adds a generated stress scene to the world. Must be called
+ * before initGameWindow. When reportFileName is not NULL, the average
+ * timings of the run are appended to it when the window is closed.
+ */
+void setGameWindowStressScene( GameWindow *gameWindow, const StressSceneConfig *config, const char *reportFileName );
+
+/**
+ * @brief Starts with the tile map level, imported or generated from
+ * config. Must be called before initGameWindow.
+ */
+void setGameWindowTileMap( GameWindow *gameWindow, const TileMapConfig *config );
+
+/**
+ * @brief Streams a music file while the window is open. Must be called
+ * before initGameWindow.
+ */
+void setGameWindowMusic( GameWindow *gameWindow, const char *fileName );
+
 /**
  * @brief Destroys a GameWindow object and its dependecies.
  */
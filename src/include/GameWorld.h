@@ -11,29 +11,73 @@
 #include "box2d/box2d.h"
 
 #include "Types.h"
+#include "GameRenderer.h"
 
 /**
- * @brief Creates a dinamically allocated GameWorld struct instance.
+ * @brief Creates a GameWorld struct instance with a walled area of
+ * width x height, allocated from the level arena, and loads its default
+ * level. Only one world can exist at a time.
  */
-GameWorld* createGameWorld( void );
+GameWorld* createGameWorld( float width, float height );
 
 /**
- * @brief Destroys a GameWindow object and its dependecies.
+ * @brief Destroys a GameWorld object and its Box2D world, releasing the
+ * level arena.
  */
 void destroyGameWorld( GameWorld *gw );
 
 /**
- * @brief Reads user input and updates the state of the game.
+ * @brief Registers a level. Returns its index or -1 if there is no room.
  */
-void updateGameWorld( GameWorld *gw, float delta );
+int addGameWorldLevel( GameWorld *gw, const LevelDef *level );
 
 /**
- * @brief Draws the state of the game.
+ * @brief Loads a registered level, unloading the current one first. The
+ * entity arrays, the Box2D world pools and the renderer resources of the
+ * previous level are reused.
  */
-void drawGameWorld( GameWorld *gw );
+bool loadGameWorldLevel( GameWorld *gw, int index );
 
-void handleChainObjectCreation( GameWorld *gw );
+/**
+ * @brief Removes the bodies of the current level. The Box2D world is
+ * kept, so its pools keep their capacity for the next level.
+ */
+void unloadGameWorldLevel( GameWorld *gw );
+
+/**
+ * @brief Loads the current level again, e.g. for a restart.
+ */
+void reloadGameWorldLevel( GameWorld *gw );
+
+/**
+ * @brief Switches to the level that comes offset levels after the
+ * current one, wrapping around.
+ */
+void switchGameWorldLevel( GameWorld *gw, int offset );
+
+/**
+ * @brief Applies user input and updates the state of the game.
+ */
+void updateGameWorld( GameWorld *gw, const GameInput *input, float delta );
+
+/**
+ * @brief Copies the render relevant state of the game into a snapshot.
+ */
+void captureRenderSnapshot( GameWorld *gw, RenderSnapshot *rs );
+
+/**
+ * @brief Draws a snapshot of the state of the game.
+ */
+void drawGameWorld( RenderSnapshot *rs, GameRenderer *gr );
+
+void handleChainObjectCreation( GameWorld *gw, const GameInput *input );
+void handleDynamicObstacleCreation( GameWorld *gw, const GameInput *input );
+void requestLineOfSight( GameWorld *gw, const GameInput *input );
+void drawLineOfSight( RenderSnapshot *rs );
+void syncRenderTransforms( GameWorld *gw );
 void createDummyObstcales( GameWorld *gw );
 
 void handleContactEvents( GameWorld *gw );
-void handleContacBetweenShapes( b2ShapeId sIdA, b2ShapeId sIdB, Color color );
\ No newline at end of file
+void addParticleEmitter( GameWorld *gw, b2Vec2 position, b2Vec2 direction, float speed, int quantity, Color color );
+void addImpact( GameWorld *gw, const b2ContactHitEvent *event );
+void handleContacBetweenShapes( GameWorld *gw, b2ShapeId sIdA, b2ShapeId sIdB, Color color );
\ No newline at end of file
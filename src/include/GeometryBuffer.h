@@ -0,0 +1,78 @@
+/**
+ * @file GeometryBuffer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Streaming geometry buffer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define GEOMETRY_BUFFER_RING_SIZE 3
+
+typedef struct GeometryVertex {
+    float x;
+    float y;
+    unsigned char color[4];
+} GeometryVertex;
+
+/**
+ * @brief CPU side array of packed triangle vertices that callers write
+ * into directly, streamed to the GPU on flush and drawn with one call.
+ * Uploads rotate over a ring of vertex buffers, so a buffer is only
+ * rewritten after the GPU had GEOMETRY_BUFFER_RING_SIZE - 1 draws to
+ * finish reading it.
+ */
+typedef struct GeometryBuffer {
+
+    unsigned int shaderId;
+    int mvpLoc;
+
+    unsigned int vaoIds[GEOMETRY_BUFFER_RING_SIZE];
+    unsigned int vboIds[GEOMETRY_BUFFER_RING_SIZE];
+    int ringIndex;
+
+    GeometryVertex *vertices;
+    int capacity;
+    int vertexQuantity;
+
+    // counters of the current frame
+    int frameVertices;
+    int frameFlushes;
+    int peakFrameVertices;
+
+    bool ready;
+
+} GeometryBuffer;
+
+/**
+ * @brief Creates a dinamically allocated GeometryBuffer struct instance
+ * holding up to capacity vertices between flushes. Needs an OpenGL
+ * context.
+ */
+GeometryBuffer* createGeometryBuffer( int capacity );
+
+/**
+ * @brief Destroys a GeometryBuffer object and its GPU resources.
+ */
+void destroyGeometryBuffer( GeometryBuffer *gb );
+
+/**
+ * @brief Resets the frame counters.
+ */
+void beginGeometryFrame( GeometryBuffer *gb );
+
+/**
+ * @brief Reserves count triangle vertices to be written by the caller,
+ * flushing first if they don't fit. Returns NULL if count is larger than
+ * the capacity or the buffer is not available.
+ */
+GeometryVertex* reserveGeometryVertices( GeometryBuffer *gb, int count );
+
+/**
+ * @brief Draws all the written vertices in one call.
+ */
+void flushGeometryBuffer( GeometryBuffer *gb );
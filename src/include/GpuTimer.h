@@ -0,0 +1,60 @@
+/**
+ * @file GpuTimer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GPU timer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#define GPU_TIMER_QUERIES 4
+
+/**
+ * @brief Measures the GPU time of the frames with OpenGL timer queries.
+ * Results are read a few frames later, so the CPU never waits for the
+ * GPU.
+ */
+typedef struct GpuTimer {
+
+    unsigned int queries[GPU_TIMER_QUERIES];
+    bool pending[GPU_TIMER_QUERIES];
+    int current;
+    bool running;
+
+    // milliseconds
+    double lastTime;
+    double averageTime;
+    int samples;
+
+    bool ready;
+
+} GpuTimer;
+
+/**
+ * @brief Creates a dinamically allocated GpuTimer struct instance. Needs
+ * an OpenGL 3.3 context, otherwise the timer stays not ready and its
+ * functions do nothing.
+ */
+GpuTimer* createGpuTimer( void );
+
+/**
+ * @brief Destroys a GpuTimer object and its queries.
+ */
+void destroyGpuTimer( GpuTimer *gt );
+
+/**
+ * @brief Starts measuring the GPU commands of a frame.
+ */
+void beginGpuTimer( GpuTimer *gt );
+
+/**
+ * @brief Stops measuring and collects the results that are available.
+ */
+void endGpuTimer( GpuTimer *gt );
+
+/**
+ * @brief Restarts the average, e.g. when the render settings change.
+ */
+void resetGpuTimer( GpuTimer *gt );
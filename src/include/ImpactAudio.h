@@ -0,0 +1,94 @@
+/**
+ * @file ImpactAudio.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Impact audio struct and function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+#define IMPACT_AUDIO_VOICES 16
+
+// hits remembered to drop the repeated ones of a body pair
+#define IMPACT_AUDIO_PAIR_HISTORY 64
+
+// loudest hits started per frame, the others are dropped
+#define IMPACT_AUDIO_MAX_STARTS 4
+
+/**
+ * @brief A preallocated sound sharing the samples of the impact sound.
+ */
+typedef struct ImpactVoice {
+    Sound sound;
+    float speed;
+    double startTime;
+} ImpactVoice;
+
+typedef struct ImpactPair {
+    uint64_t key;
+    double time;
+} ImpactPair;
+
+/**
+ * @brief Plays the hits of the snapshots through a fixed pool of voices,
+ * so a pile-up costs the same as a single hit: the hits of a body pair
+ * closer than dedupeWindow seconds are dropped, only the fastest ones of
+ * a frame are started and a voice is stolen from the quietest playing
+ * hit only when the new one is louder.
+ */
+typedef struct ImpactAudio {
+
+    Sound impactSound;
+    ImpactVoice voices[IMPACT_AUDIO_VOICES];
+    bool ready;
+
+    ImpactPair pairs[IMPACT_AUDIO_PAIR_HISTORY];
+    int pairCursor;
+
+    float dedupeWindow;
+    float minSpeed;
+    float fullVolumeSpeed;
+    float duration;
+    float width;
+
+    // hits of the snapshots already heard
+    int impactTotal;
+
+    // counters of the current frame
+    int received;
+    int deduplicated;
+    int limited;
+    int started;
+    int stolen;
+    int playing;
+
+} ImpactAudio;
+
+/**
+ * @brief Creates a dinamically allocated ImpactAudio struct instance with
+ * a procedural impact sound. Without an audio device the hits are only
+ * counted. width is the size of the world, for the stereo panning.
+ */
+ImpactAudio* createImpactAudio( float width );
+
+/**
+ * @brief Destroys an ImpactAudio object and its sounds.
+ */
+void destroyImpactAudio( ImpactAudio *ia );
+
+/**
+ * @brief Plays the hits of the snapshot that weren't heard yet.
+ */
+void updateImpactAudio( ImpactAudio *ia, const RenderSnapshot *rs );
+
+/**
+ * @brief Draws the impact audio counters.
+ */
+void drawImpactAudioStats( const ImpactAudio *ia, int x, int y );
@@ -0,0 +1,86 @@
+/**
+ * @file InstancedRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Instanced box renderer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+// vertices of the unit quad drawn for each instance
+#define UNIT_QUAD_VERTEX_QUANTITY 6
+
+typedef struct BoxInstance {
+    float x;
+    float y;
+    float width;
+    float height;
+    float cos;
+    float sin;
+    unsigned char color[4];
+} BoxInstance;
+
+/**
+ * @brief Gathers oriented boxes into an instance buffer and draws all of
+ * them with a single instanced draw call.
+ */
+typedef struct InstancedRenderer {
+
+    unsigned int shaderId;
+    int mvpLoc;
+
+    unsigned int vaoId;
+    unsigned int quadVboId;
+    unsigned int instanceVboId;
+
+    BoxInstance *instances;
+    int capacity;
+    int instanceQuantity;
+
+    // counters of the current frame
+    int drawnInstances;
+    int culledInstances;
+    int drawCalls;
+
+    bool ready;
+
+} InstancedRenderer;
+
+/**
+ * @brief Unit quad centered at the origin, two triangles wound counter
+ * clockwise on the screen like DrawRectangle, since raylib culls the back
+ * faces.
+ */
+extern const float unitQuadVertices[UNIT_QUAD_VERTEX_QUANTITY*2];
+
+/**
+ * @brief Creates a dinamically allocated InstancedRenderer struct instance
+ * holding up to capacity boxes per draw call. Needs an OpenGL context.
+ */
+InstancedRenderer* createInstancedRenderer( int capacity );
+
+/**
+ * @brief Destroys an InstancedRenderer object and its GPU resources.
+ */
+void destroyInstancedRenderer( InstancedRenderer *ir );
+
+/**
+ * @brief Resets the frame counters.
+ */
+void beginInstancedFrame( InstancedRenderer *ir );
+
+/**
+ * @brief Adds a box centered at position. Boxes outside the screen are
+ * culled. The batch is flushed when full.
+ */
+void addBoxInstance( InstancedRenderer *ir, b2Vec2 position, b2Rot rotation, Vector2 dim, Color color );
+
+/**
+ * @brief Draws the gathered boxes in a single instanced draw call.
+ */
+void flushBoxInstances( InstancedRenderer *ir );
@@ -0,0 +1,58 @@
+/**
+ * @file LabelCache.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Chain vertex label cache struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+/**
+ * @brief The vertex coordinate labels of the chain obstacles, formatted
+ * and laid out once into a render texture and drawn as a single quad
+ * until the static geometry changes.
+ */
+typedef struct LabelCache {
+
+    RenderTexture2D target;
+    int revision;
+    int carvedRegions;
+    bool valid;
+    int rebuilds;
+
+} LabelCache;
+
+/**
+ * @brief Creates a dinamically allocated LabelCache struct instance.
+ * Needs an OpenGL context.
+ */
+LabelCache* createLabelCache( void );
+
+/**
+ * @brief Destroys a LabelCache object and its render texture.
+ */
+void destroyLabelCache( LabelCache *lc );
+
+/**
+ * @brief Marks the cache as outdated.
+ */
+void invalidateLabelCache( LabelCache *lc );
+
+/**
+ * @brief Rebuilds the cache if the static geometry of the snapshot
+ * changed. Must be called between BeginDrawing and EndDrawing, outside
+ * of any other texture mode.
+ */
+void updateLabelCache( LabelCache *lc, RenderSnapshot *rs );
+
+/**
+ * @brief Draws the labels of the chain obstacles cached by
+ * updateLabelCache.
+ */
+void drawLabelCache( LabelCache *lc );
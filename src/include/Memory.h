@@ -0,0 +1,151 @@
+/**
+ * @file Memory.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Memory tracking, arenas and frame scratch struct and function
+ * declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define MEMORY_FRAME_SCRATCH_CAPACITY ( 1024 * 1024 )
+
+// frames ignored by the steady state check, while the pools warm up
+#define MEMORY_WARM_UP_FRAMES 120
+
+typedef enum MemorySubsystem {
+    MEMORY_SUBSYSTEM_BOX2D,
+    MEMORY_SUBSYSTEM_WORLD,
+    MEMORY_SUBSYSTEM_RENDER,
+    MEMORY_SUBSYSTEM_WINDOW,
+    MEMORY_SUBSYSTEM_SCRATCH,
+    MEMORY_SUBSYSTEM_COUNT
+} MemorySubsystem;
+
+typedef struct MemorySubsystemStats {
+
+    long long bytes;
+    long long peakBytes;
+    long long allocations;
+    long long frees;
+
+    // heap allocations in the last frame
+    long long frameAllocations;
+
+} MemorySubsystemStats;
+
+typedef struct MemoryReport {
+
+    MemorySubsystemStats subsystems[MEMORY_SUBSYSTEM_COUNT];
+
+    long long bytes;
+    long long blocks;
+    long long frameAllocations;
+
+    int frames;
+    int allocatingFrames;
+
+    size_t scratchCapacity;
+    size_t scratchPeak;
+    int scratchOverflows;
+
+} MemoryReport;
+
+/**
+ * @brief Linear allocator. Allocations are bump pointers into a single
+ * block and are all released at once by resetMemoryArena.
+ */
+typedef struct MemoryArena {
+
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+    size_t peak;
+
+} MemoryArena;
+
+/**
+ * @brief Installs the tracking allocator into Box2D and creates the frame
+ * scratch. Must be called before any Box2D world is created.
+ */
+void initMemory( size_t frameScratchCapacity );
+
+/**
+ * @brief Allocates size bytes accounted to subsystem, 16 bytes aligned.
+ */
+void* allocMemory( MemorySubsystem subsystem, size_t size );
+
+/**
+ * @brief Allocates size bytes accounted to subsystem, aligned to a power
+ * of two alignment.
+ */
+void* allocAlignedMemory( MemorySubsystem subsystem, size_t size, size_t alignment );
+
+/**
+ * @brief Releases memory allocated by allocMemory or allocAlignedMemory.
+ */
+void freeMemory( void *ptr );
+
+/**
+ * @brief Creates a dinamically allocated MemoryArena struct instance
+ * with capacity bytes, accounted to subsystem.
+ */
+MemoryArena* createMemoryArena( MemorySubsystem subsystem, size_t capacity );
+
+/**
+ * @brief Destroys a MemoryArena object and its block.
+ */
+void destroyMemoryArena( MemoryArena *arena );
+
+/**
+ * @brief Allocates from the arena. Returns NULL when it is full.
+ */
+void* allocMemoryArena( MemoryArena *arena, size_t size, size_t alignment );
+
+/**
+ * @brief Releases every allocation of the arena, keeping its block.
+ */
+void resetMemoryArena( MemoryArena *arena );
+
+/**
+ * @brief Frame scratch, for temporaries of the thread that draws.
+ * Allocations are released to a mark taken before them. allocFrameScratch
+ * returns NULL when the scratch is full or wasn't initialized, so callers
+ * can fall back to allocMemory.
+ */
+size_t getFrameScratchMark( void );
+void* allocFrameScratch( size_t size );
+void releaseFrameScratch( size_t mark );
+
+/**
+ * @brief Marks the frame boundaries for the steady state check: frames
+ * past the warm up that allocate from the heap are counted and logged.
+ */
+void beginMemoryFrame( void );
+void endMemoryFrame( void );
+
+/**
+ * @brief Starts a new warm up, e.g. after a level is loaded. Can be
+ * called from any thread.
+ */
+void restartMemoryWarmUp( void );
+
+/**
+ * @brief Reads the current counters.
+ */
+MemoryReport getMemoryReport( void );
+
+/**
+ * @brief Draws the bytes and allocations per subsystem.
+ */
+void drawMemoryStats( int x, int y );
+
+/**
+ * @brief Logs the bytes and allocations per subsystem.
+ */
+void logMemoryReport( void );
+
+const char* getMemorySubsystemName( MemorySubsystem subsystem );
@@ -2,5 +2,18 @@
 
 #include "Types.h"
 
-void createObstacle( float x, float y, float w, float h, Color color, GameWorld *gw );
-void drawObstacle( Obstacle *o );
\ No newline at end of file
+/**
+ * @brief Creates a static box obstacle. flags are ShapeFlag bits, e.g.
+ * SHAPE_FLAG_ONE_WAY for a platform that can be jumped through.
+ */
+void createObstacle( float x, float y, float w, float h, Color color, unsigned int flags, GameWorld *gw );
+void createDynamicObstacle( float x, float y, float w, float h, Color color, GameWorld *gw );
+void drawObstacle( Obstacle *o );
+
+/**
+ * @brief Same test as the Box2D sleep: the linear speed and the speed of
+ * the farthest corner due to the rotation are below the sleep threshold
+ * of the body. Bodies put to sleep by hand must pass it, or they freeze
+ * with their island while still moving.
+ */
+bool isObstacleSlow( const Obstacle *o );
\ No newline at end of file
@@ -0,0 +1,45 @@
+/**
+ * @file OneWayPlatform.h
+ * @author Prof. Dr. David Buzatto
+ * @brief One way platform function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#include "Types.h"
+
+/**
+ * @brief Initializes the one way platforms and registers their presolve
+ * callback in the world.
+ */
+void initOneWayPlatforms( OneWayPlatforms *owp, b2WorldId worldId );
+
+/**
+ * @brief Registers or removes the presolve callback. Without it the one
+ * way platforms are solid.
+ */
+void setOneWayPlatformsEnabled( OneWayPlatforms *owp, b2WorldId worldId, bool enabled );
+
+/**
+ * @brief Collects the counters of the last step, to be called after
+ * b2World_Step.
+ */
+void updateOneWayPlatformStats( OneWayPlatforms *owp, b2WorldId worldId );
+
+/**
+ * @brief Returns the ShapeFlag bits of the obstacle that owns a shape.
+ * Only reads the shape and the obstacle, so it is safe to call from the
+ * solver threads.
+ */
+unsigned int getShapeFlags( b2ShapeId shapeId );
+
+/**
+ * @brief Draws the one way platform counters.
+ */
+void drawOneWayPlatformStats( const OneWayPlatformStats *stats, int x, int y );
@@ -0,0 +1,109 @@
+/**
+ * @file ParticleSystem.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Particle system struct and function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+#define PARTICLE_SYSTEM_CAPACITY 131072
+
+// seconds of the fade out at the end of the life of a particle
+#define PARTICLE_FADE_TIME 0.3f
+
+/**
+ * @brief Fixed capacity pool of particles in structure of arrays layout,
+ * so the update runs over contiguous floats, four at a time when SSE is
+ * available. The live particles are always the first quantity ones: dead
+ * particles are replaced by the last live one. They are drawn with a
+ * single instanced draw call that reads the arrays directly.
+ */
+typedef struct ParticleSystem {
+
+    float *x;
+    float *y;
+    float *vx;
+    float *vy;
+    float *life;
+    Color *color;
+
+    int capacity;
+    int quantity;
+
+    float gravity;
+    float damping;
+    float size;
+
+    uint32_t seed;
+
+    // bursts of the snapshots already spawned
+    int emitterTotal;
+
+    unsigned int shaderId;
+    int mvpLoc;
+    int sizeLoc;
+    int fadeLoc;
+    unsigned int vaoId;
+    unsigned int quadVboId;
+    unsigned int xVboId;
+    unsigned int yVboId;
+    unsigned int lifeVboId;
+    unsigned int colorVboId;
+    bool ready;
+
+    // spawned and dropped count since the creation, the others count the
+    // current frame
+    int spawned;
+    int killed;
+    int dropped;
+    int drawCalls;
+    double updateTime;
+
+} ParticleSystem;
+
+/**
+ * @brief Creates a dinamically allocated ParticleSystem struct instance
+ * holding up to capacity particles. Needs an OpenGL context to draw,
+ * without one (or its shader) the particles are drawn one by one.
+ */
+ParticleSystem* createParticleSystem( int capacity, float gravity );
+
+/**
+ * @brief Destroys a ParticleSystem object and its GPU resources.
+ */
+void destroyParticleSystem( ParticleSystem *ps );
+
+/**
+ * @brief Spawns the particles of a burst. Particles that don't fit are
+ * dropped.
+ */
+void emitParticles( ParticleSystem *ps, const ParticleEmitter *emitter );
+
+/**
+ * @brief Spawns the bursts of the snapshot that weren't spawned yet.
+ */
+void emitSnapshotParticles( ParticleSystem *ps, const RenderSnapshot *rs );
+
+/**
+ * @brief Moves the particles delta seconds forward and removes the ones
+ * whose life ended.
+ */
+void updateParticleSystem( ParticleSystem *ps, float delta );
+
+/**
+ * @brief Draws the live particles.
+ */
+void drawParticleSystem( ParticleSystem *ps );
+
+/**
+ * @brief Draws the particle counters.
+ */
+void drawParticleStats( const ParticleSystem *ps, int x, int y );
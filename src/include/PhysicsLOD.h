@@ -0,0 +1,35 @@
+/**
+ * @file PhysicsLOD.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation level of detail function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#include "Types.h"
+
+/**
+ * @brief Initializes the level of detail rings.
+ */
+void initPhysicsLOD( PhysicsLOD *lod, float sleepRadius, float disableRadius, float hysteresis, int budget );
+
+/**
+ * @brief Evaluates up to lod->budget dynamic obstacles against the rings
+ * centered at focus, demoting or promoting them as needed.
+ */
+void updatePhysicsLOD( PhysicsLOD *lod, GameWorld *gw, b2Vec2 focus );
+
+/**
+ * @brief Enables or disables the level of detail system. Disabling it
+ * promotes every body back to full rate simulation.
+ */
+void setPhysicsLODEnabled( PhysicsLOD *lod, GameWorld *gw, bool enabled );
+
+/**
+ * @brief Draws the level of detail counters.
+ */
+void drawPhysicsLODStats( const PhysicsLOD *lod, int x, int y );
@@ -3,5 +3,5 @@
 #include "Types.h"
 
 void createPlayer( Player *p, float x, float y, float w, float h, Color color, GameWorld *gw );
-void updatePlayer( Player *p );
+void updatePlayer( Player *p, const GameInput *input );
 void drawPlayer( Player *p );
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * @file PolygonUtils.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Polygon cleanup and validation function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "box2d/box2d.h"
+
+// largest polygon decomposeConvexPolygon accepts
+#define CONVEX_DECOMPOSITION_MAX_VERTICES 256
+
+// limits of subtractPolygon, its work buffers live on the stack
+#define POLYGON_SUBTRACTION_MAX_VERTICES 64
+#define POLYGON_SUBTRACTION_MAX_INTERSECTIONS 128
+
+/**
+ * @brief Outcome of subtractPolygon.
+ */
+typedef enum PolygonSubtraction {
+    POLYGON_SUBTRACTION_DISJOINT,
+    POLYGON_SUBTRACTION_REMOVED,
+    POLYGON_SUBTRACTION_CLIPPED,
+    POLYGON_SUBTRACTION_HOLE,
+    POLYGON_SUBTRACTION_FAILED
+} PolygonSubtraction;
+
+/**
+ * @brief Tolerances, in length units, of the cleanup of a closed polygon.
+ * Zero disables a stage.
+ */
+typedef struct PolygonCleanupSettings {
+    float weldTolerance;
+    float collinearTolerance;
+    float simplifyTolerance;
+} PolygonCleanupSettings;
+
+/**
+ * @brief Convex piece of a decomposed polygon, with the same winding.
+ */
+typedef struct ConvexPiece {
+    b2Vec2 points[B2_MAX_POLYGON_VERTICES];
+    int pointCount;
+} ConvexPiece;
+
+/**
+ * @brief Merges consecutive vertices closer than tolerance, including the
+ * last and the first one. Works in place and returns the new quantity of
+ * vertices.
+ */
+int weldPolygonVertices( b2Vec2 *points, int pointCount, float tolerance );
+
+/**
+ * @brief Removes the vertices closer than tolerance to the line through
+ * their neighbors, which also removes zero width spikes. Works in place
+ * and returns the new quantity of vertices.
+ */
+int removeCollinearVertices( b2Vec2 *points, int pointCount, float tolerance );
+
+/**
+ * @brief Douglas-Peucker simplification of a closed polygon: keeps the
+ * vertices needed so no removed one is farther than tolerance from the
+ * result. Works in place and returns the new quantity of vertices.
+ */
+int simplifyPolygon( b2Vec2 *points, int pointCount, float tolerance );
+
+/**
+ * @brief Runs welding, collinear removal and simplification, in this
+ * order. Works in place and returns the new quantity of vertices, which
+ * can be less than 3 for degenerate input.
+ */
+int cleanupPolygon( b2Vec2 *points, int pointCount, const PolygonCleanupSettings *settings );
+
+/**
+ * @brief Shoelace area, positive for clockwise polygons on the screen,
+ * with y growing down.
+ */
+float computePolygonSignedArea( const b2Vec2 *points, int pointCount );
+
+/**
+ * @brief Reverses the winding of a polygon, in place.
+ */
+void reversePolygon( b2Vec2 *points, int pointCount );
+
+/**
+ * @brief Shamos-Hoey sweep line check of a closed polygon, O(n log n).
+ * Returns true if two of its edges cross, touch or overlap, writing the
+ * indices of the edges, edge i going from vertex i to vertex i + 1, and
+ * a point shared by them. Adjacent edges only intersect when one folds
+ * back over the other. Repeated consecutive vertices must be welded
+ * first. Chain obstacles pass at most MAX_CHAIN_OBSTACLE_POINTS - 1
+ * vertices, where the sweep runs on the stack buffers and is hardly
+ * faster than the pairwise check; it pays off on larger outlines.
+ */
+bool findPolygonSelfIntersection( const b2Vec2 *points, int pointCount, int *edgeA, int *edgeB, b2Vec2 *intersection );
+
+/**
+ * @brief Splits a closed polygon in two at an intersection of edges edgeA
+ * and edgeB, edgeA < edgeB, found by findPolygonSelfIntersection. Both
+ * loops get the intersection point and have less vertices than the
+ * polygon. first and second need room for pointCount vertices.
+ */
+void splitPolygonAtIntersection( const b2Vec2 *points, int pointCount, int edgeA, int edgeB, b2Vec2 intersection,
+                                 b2Vec2 *first, int *firstCount, b2Vec2 *second, int *secondCount );
+
+/**
+ * @brief Hertel-Mehlhorn decomposition of a simple polygon into convex
+ * pieces of at most B2_MAX_POLYGON_VERTICES vertices: ear clipping, then
+ * the diagonals whose removal keeps both sides convex are removed.
+ * Returns the quantity of pieces written, at most four times the optimum,
+ * or 0 if the polygon can't be decomposed into maxPieces pieces.
+ */
+int decomposeConvexPolygon( const b2Vec2 *points, int pointCount, ConvexPiece *pieces, int maxPieces );
+
+/**
+ * @brief Greiner-Hormann subtraction of the simple polygon clip from the
+ * simple polygon subject. When the outlines cross, the remaining pieces
+ * are written one after the other into result, their vertex quantities
+ * into resultCounts and their quantity into *resultQuantity, with the
+ * winding of subject, and CLIPPED is returned. Otherwise subject is
+ * either untouched (DISJOINT), covered (REMOVED) or would get a hole
+ * (HOLE). Vertices lying on the other outline are resolved by nudging
+ * clip a little. FAILED means the limits or the capacities were exceeded.
+ */
+PolygonSubtraction subtractPolygon( const b2Vec2 *subject, int subjectCount, const b2Vec2 *clip, int clipCount,
+                                    b2Vec2 *result, int resultCapacity, int *resultCounts, int maxResults, int *resultQuantity );
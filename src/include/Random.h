@@ -0,0 +1,31 @@
+/**
+ * @file Random.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Deterministic random number function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Advances a xorshift32 state and returns it. The state must not
+ * be zero.
+ */
+uint32_t nextRandom( uint32_t *state );
+
+/**
+ * @brief Returns a float in [0, 1) from the high 24 bits of the next value.
+ */
+float nextRandomFloat( uint32_t *state );
+
+/**
+ * @brief Returns a float in [min, max].
+ */
+float randomRange( uint32_t *state, float min, float max );
+
+/**
+ * @brief Returns an int in [min, max].
+ */
+int randomInt( uint32_t *state, int min, int max );
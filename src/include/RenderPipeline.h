@@ -0,0 +1,73 @@
+/**
+ * @file RenderPipeline.h
+ * @author Prof. Dr. David Buzatto
+ * @brief RenderPipeline struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "Types.h"
+
+// longest step, in seconds, made from the frames accumulated while the
+// simulation thread was busy
+#define RENDER_PIPELINE_MAX_DELTA ( 4.0f / 60.0f )
+
+/**
+ * @brief Runs the simulation in its own thread, one frame ahead of the
+ * render thread. Snapshots are exchanged through a triple buffer: the
+ * simulation thread writes into one, the render thread reads from
+ * another and the third holds the latest published snapshot. Only the
+ * buffer indices are swapped under the lock, so none of the threads
+ * waits for the other's work.
+ */
+typedef struct RenderPipeline {
+
+    GameWorld *gw;
+
+    RenderSnapshot *snapshots[3];
+    int writeIndex;
+    int readyIndex;
+    int readIndex;
+    bool readyIsNew;
+
+    GameInput pendingInput;
+    float pendingDelta;
+    bool stepRequested;
+    bool running;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t stepCondition;
+
+} RenderPipeline;
+
+/**
+ * @brief Creates a dinamically allocated RenderPipeline struct instance
+ * and starts its simulation thread. From now on the GameWorld must only
+ * be touched by the pipeline. Returns NULL if the thread can't be
+ * started.
+ */
+RenderPipeline* createRenderPipeline( GameWorld *gw );
+
+/**
+ * @brief Stops the simulation thread and destroys the RenderPipeline.
+ * The GameWorld is not destroyed.
+ */
+void destroyRenderPipeline( RenderPipeline *rp );
+
+/**
+ * @brief Hands the input of the current frame to the simulation thread.
+ * If the previous step is still running, input and delta are accumulated
+ * for the next one, up to RENDER_PIPELINE_MAX_DELTA seconds.
+ */
+void submitRenderPipelineInput( RenderPipeline *rp, const GameInput *input, float delta );
+
+/**
+ * @brief Returns the latest published snapshot. It stays valid until the
+ * next call.
+ */
+RenderSnapshot* acquireRenderPipelineSnapshot( RenderPipeline *rp );
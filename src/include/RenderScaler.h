@@ -0,0 +1,82 @@
+/**
+ * @file RenderScaler.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Internal resolution scaler struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#define RENDER_SCALE_MIN 0.5f
+#define RENDER_SCALE_MAX 1.0f
+#define RENDER_SCALE_STEP 0.05f
+
+/**
+ * @brief Renders the scene into an offscreen target at a fraction of the
+ * window resolution and upscales it to the window with a sharp bilinear
+ * filter. When dynamic, the scale follows the frame time budget. With
+ * fxaa, the target is resolved through an FXAA pass instead, even at
+ * full scale. The target is not multisampled, so MSAA only applies at
+ * full scale without fxaa.
+ */
+typedef struct RenderScaler {
+
+    RenderTexture2D target;
+    Shader upscaleShader;
+    int textureSizeLoc;
+    int prescaleLoc;
+
+    bool fxaa;
+    Shader fxaaShader;
+    int fxaaTextureSizeLoc;
+
+    float scale;
+    bool dynamic;
+    bool active;
+
+    // dynamic resolution: frames over/within the budget in a row
+    float frameBudget;
+    int overBudgetFrames;
+    int withinBudgetFrames;
+
+} RenderScaler;
+
+/**
+ * @brief Creates a dinamically allocated RenderScaler struct instance.
+ * Needs an OpenGL context.
+ */
+RenderScaler* createRenderScaler( float scale, bool dynamic, int targetFPS );
+
+/**
+ * @brief Destroys a RenderScaler object and its GPU resources.
+ */
+void destroyRenderScaler( RenderScaler *rsc );
+
+/**
+ * @brief Sets the internal resolution scale, clamped to
+ * [RENDER_SCALE_MIN, RENDER_SCALE_MAX].
+ */
+void setRenderScale( RenderScaler *rsc, float scale );
+
+/**
+ * @brief Feeds the last frame time, in seconds, to the dynamic
+ * resolution controller.
+ */
+void updateRenderScale( RenderScaler *rsc, float frameTime );
+
+/**
+ * @brief Starts drawing the scene, clearing it with color. Below full
+ * scale or with fxaa the scene goes to the offscreen target, so it must be called
+ * between BeginDrawing and EndDrawing, outside of any other texture mode.
+ */
+void beginScaledScene( RenderScaler *rsc, Color color );
+
+/**
+ * @brief Finishes the scene started by beginScaledScene, upscaling it to
+ * the window when needed.
+ */
+void endScaledScene( RenderScaler *rsc );
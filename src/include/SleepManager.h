@@ -0,0 +1,30 @@
+/**
+ * @file SleepManager.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Sleep management function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#include "Types.h"
+
+/**
+ * @brief Initializes the sleep settings. Must be called before the
+ * bodies are created, since they read their thresholds from it.
+ */
+void initSleepManager( SleepManager *sm, Rectangle activeRegion, float wakeRadius, int budget );
+
+/**
+ * @brief Forces slow bodies outside the active region to sleep and wakes
+ * sleeping bodies near the focus.
+ */
+void updateSleepManager( SleepManager *sm, GameWorld *gw, b2Vec2 focus );
+
+/**
+ * @brief Draws the awake/asleep counters and island statistics.
+ */
+void drawSleepStats( const SleepManager *sm, int x, int y );
@@ -0,0 +1,71 @@
+/**
+ * @file SpatialQuery.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Batched spatial query service function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include "raylib/raylib.h"
+#include "box2d/box2d.h"
+
+#include "Types.h"
+
+/**
+ * @brief Initializes the query service. Cached results are reused while
+ * the query origin and target stay in the same cells of cacheCellSize
+ * units, for at most cacheTicks ticks.
+ */
+void initSpatialQueryService( SpatialQueryService *sqs, float cacheCellSize, int cacheTicks );
+
+/**
+ * @brief Stops the worker threads of the service, if they were started.
+ */
+void destroySpatialQueryService( SpatialQueryService *sqs );
+
+/**
+ * @brief Drops the pending queries and the cached results, which refer
+ * to shapes of the previous level.
+ */
+void clearSpatialQueryCache( SpatialQueryService *sqs );
+
+/**
+ * @brief Starts a new tick, discarding the queries of the previous one.
+ */
+void beginSpatialQueryTick( SpatialQueryService *sqs );
+
+/**
+ * @brief Requests a closest hit ray cast. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestRayQuery( SpatialQueryService *sqs, b2Vec2 origin, b2Vec2 translation, b2QueryFilter filter );
+
+/**
+ * @brief Requests an AABB overlap query. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestAABBQuery( SpatialQueryService *sqs, b2AABB aabb, b2QueryFilter filter );
+
+/**
+ * @brief Requests a closest hit shape cast. Returns a query handle or -1
+ * if the queue is full.
+ */
+int requestShapeCastQuery( SpatialQueryService *sqs, const b2ShapeProxy *proxy, b2Vec2 translation, b2QueryFilter filter );
+
+/**
+ * @brief Executes all pending queries of the tick in one batch. Must be
+ * called while the world is not being stepped.
+ */
+void executeSpatialQueries( SpatialQueryService *sqs, b2WorldId worldId );
+
+/**
+ * @brief Returns the result of a query, or NULL if the handle is invalid
+ * or the query was not executed yet.
+ */
+const SpatialQueryResult* getSpatialQueryResult( const SpatialQueryService *sqs, int handle );
+
+/**
+ * @brief Draws the query counters and tree statistics of the last tick.
+ */
+void drawSpatialQueryStats( const SpatialQueryStats *stats, int x, int y );
@@ -0,0 +1,81 @@
+/**
+ * @file StaticLayer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Static background layer struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+#define STATIC_LAYER_TILE_SIZE 256
+#define STATIC_LAYER_MAX_TILES 64
+
+/**
+ * @brief A screen region of the static layer. The render texture is
+ * only allocated when some static entity overlaps the tile.
+ */
+typedef struct StaticLayerTile {
+    RenderTexture2D target;
+    Rectangle bounds;
+    bool dirty;
+    bool empty;
+} StaticLayerTile;
+
+/**
+ * @brief The static scenery (walls, chain obstacles, their outlines and
+ * labels) rendered once into tiled render textures and drawn as a few
+ * textured quads. A tile is rendered again only when a static entity
+ * overlapping it is added or changes its appearance.
+ */
+typedef struct StaticLayer {
+
+    StaticLayerTile tiles[STATIC_LAYER_MAX_TILES];
+    int tileSize;
+    int columns;
+    int rows;
+
+    int revision;
+    int builtTick;
+    int carvedRegions;
+    bool labels;
+    bool valid;
+
+    int drawnTiles;
+    int rebuiltTiles;
+    int totalRebuilds;
+
+} StaticLayer;
+
+/**
+ * @brief Creates a dinamically allocated StaticLayer struct instance.
+ * Needs an OpenGL context.
+ */
+StaticLayer* createStaticLayer( void );
+
+/**
+ * @brief Destroys a StaticLayer object and its render textures.
+ */
+void destroyStaticLayer( StaticLayer *sl );
+
+/**
+ * @brief Marks every tile as outdated.
+ */
+void invalidateStaticLayer( StaticLayer *sl );
+
+/**
+ * @brief Renders the outdated tiles of the static entities of the
+ * snapshot. Must be called between BeginDrawing and EndDrawing, outside
+ * of any other texture mode.
+ */
+void updateStaticLayer( StaticLayer *sl, RenderSnapshot *rs, bool labels );
+
+/**
+ * @brief Draws the non empty tiles updated by updateStaticLayer.
+ */
+void drawStaticLayer( StaticLayer *sl );
@@ -0,0 +1,56 @@
+/**
+ * @file StressScene.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Procedural stress scene struct and function declarations.
+ * 
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+/**
+ * @brief Accumulated frame timings of a run, in milliseconds.
+ */
+typedef struct StressReport {
+    int frames;
+    double frameTime;
+    double maxFrameTime;
+    double updateTime;
+    double stepTime;
+    double captureTime;
+    double drawTime;
+    double gpuTime;
+} StressReport;
+
+/**
+ * @brief Adds to the world, inside its walls, boxObstacles static boxes,
+ * chainObstacles random star shaped chains of chainVertices vertices and
+ * dynamicBodies boxes dropped from the top. Quantities are clamped to
+ * the free entity slots. The chain cleanup may remove a few vertices.
+ */
+void generateStressScene( GameWorld *gw, const StressSceneConfig *config );
+
+/**
+ * @brief Adds the timings of one frame to a report.
+ */
+void addStressReportSample( StressReport *sr, double frameTime, double updateTime, double stepTime,
+                            double captureTime, double drawTime, double gpuTime );
+
+/**
+ * @brief Appends the averages of a report as a CSV row, writing the
+ * header first if the file is new. Returns false if the file can't be
+ * written.
+ */
+bool writeStressReport( const char *fileName, const char *mode, const StressSceneConfig *config,
+                        GameWorld *gw, const StressReport *sr );
+
+/**
+ * @brief Runs the simulation without a window for scaling tests: for
+ * each step i from 1 to steps, a world with the quantities of the config
+ * times i is generated and simulated for frames fixed time steps, and
+ * its timings are appended to the report file.
+ */
+void runHeadlessStressTest( const StressSceneConfig *config, int steps, int frames, const char *fileName );
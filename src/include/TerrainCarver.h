@@ -0,0 +1,56 @@
+/**
+ * @file TerrainCarver.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Terrain carving function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "box2d/box2d.h"
+
+#include "Types.h"
+
+// carves made with the mouse
+#define TERRAIN_CARVER_RADIUS 30.0f
+#define TERRAIN_CARVER_CIRCLE_VERTICES 16
+
+// pieces smaller than this, in square length units, are dropped
+#define TERRAIN_CARVER_MIN_AREA 4.0f
+
+/**
+ * @brief Initializes an empty carver that subtracts at most budget chain
+ * obstacles per tick.
+ */
+void initTerrainCarver( TerrainCarver *tc, int budget );
+
+/**
+ * @brief Drops the pending requests, e.g. when the level is unloaded.
+ */
+void clearTerrainCarver( TerrainCarver *tc );
+
+/**
+ * @brief Queues the subtraction of a simple polygon from the chain
+ * obstacles. Returns false if the queue is full or the polygon has too
+ * many vertices.
+ */
+bool requestPolygonCarve( TerrainCarver *tc, const b2Vec2 *points, int pointQuantity );
+
+/**
+ * @brief Queues the subtraction of a circle, approximated by a regular
+ * polygon.
+ */
+bool requestCircleCarve( TerrainCarver *tc, b2Vec2 center, float radius );
+
+/**
+ * @brief Subtracts the pending requests from the chain obstacles they
+ * overlap, rebuilding only those, until the budget of the tick is spent.
+ */
+void updateTerrainCarver( TerrainCarver *tc, GameWorld *gw );
+
+/**
+ * @brief Draws the carving counters.
+ */
+void drawTerrainCarverStats( const TerrainCarver *tc, int x, int y );
@@ -0,0 +1,85 @@
+/**
+ * @file TileMap.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Tile map struct and function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+// thickness of the walls around the tile map
+#define TILE_MAP_WALL_MARGIN 20.0f
+
+// smaller tiles would be welded away by the chain outline cleanup
+#define TILE_MAP_MIN_CHAIN_TILE_SIZE 4.0f
+
+/**
+ * @brief Rectangle of tiles, in tile coordinates.
+ */
+typedef struct TileRect {
+    int x;
+    int y;
+    int width;
+    int height;
+    unsigned char kind;
+} TileRect;
+
+/**
+ * @brief Reads a text grid, one row per line: '.' and ' ' are empty,
+ * '#' is kind 1, '=' is kind 2 and the digits 1 to 9 are their kinds.
+ * Returns false if the grid is empty or too large.
+ */
+bool importTileMap( TileMap *tm, const char *text );
+
+/**
+ * @brief Reads a text grid file with importTileMap.
+ */
+bool loadTileMapFile( TileMap *tm, const char *fileName );
+
+/**
+ * @brief Generates a terrain of columns x rows tiles with caves and
+ * floating platforms. The same seed always generates the same map.
+ */
+bool generateTileMap( TileMap *tm, int columns, int rows, unsigned int seed );
+
+/**
+ * @brief Empties the tiles that overlap area, in world coordinates.
+ */
+void clearTileMapArea( TileMap *tm, Rectangle area );
+
+/**
+ * @brief Greedy merge step: finds the next maximal rectangle of solid
+ * tiles not yet marked in used, scanning area row by row from *cursor,
+ * and marks its tiles. used holds one byte per tile of area and starts
+ * zeroed, as does *cursor. With byKind set, a rectangle only has tiles
+ * of one kind. Returns false when every solid tile is used.
+ */
+bool findNextTileRectangle( const TileMap *tm, TileRect area, bool byKind, unsigned char *used, int *cursor, TileRect *rect );
+
+/**
+ * @brief Imports or generates the tile map of a level into the world,
+ * fitting it into the walls, and creates its colliders.
+ */
+bool loadTileMap( GameWorld *gw, const TileMapConfig *config );
+
+/**
+ * @brief Destroys the colliders of the tile map of the world.
+ */
+void unloadTileMap( GameWorld *gw );
+
+/**
+ * @brief Copies the tile map into a snapshot. The tiles are only copied
+ * when they changed since the last copy or force is set.
+ */
+void copyTileMap( TileMap *dst, const TileMap *src, bool force );
+
+/**
+ * @brief Returns the color of a tile kind.
+ */
+Color getTileColor( unsigned char kind );
@@ -0,0 +1,81 @@
+/**
+ * @file TileMapRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Chunked tile map renderer struct and function declarations.
+ *
+ * @copyright Copyright (c) 2025
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#include "Types.h"
+
+// tiles per side of a chunk
+#define TILE_MAP_CHUNK_SIZE 32
+
+/**
+ * @brief A square of tiles whose merged rectangles live in a static
+ * vertex buffer.
+ */
+typedef struct TileMapChunk {
+    Rectangle bounds;
+    unsigned int vaoId;
+    unsigned int vboId;
+    int vertexQuantity;
+} TileMapChunk;
+
+/**
+ * @brief Draws a tile map from cached meshes, one per chunk. The tiles of
+ * a chunk are merged into rectangles of the same kind when the mesh is
+ * built, which only happens when the tiles change, and chunks outside the
+ * screen are culled.
+ */
+typedef struct TileMapRenderer {
+
+    unsigned int shaderId;
+    int mvpLoc;
+    int positionLoc;
+    int colorLoc;
+
+    TileMapChunk *chunks;
+    int chunkCapacity;
+    int columns;
+    int rows;
+
+    int revision;
+    bool valid;
+
+    // counters of the current frame and of the last build
+    int drawnChunks;
+    int culledChunks;
+    int drawnVertices;
+    int builtVertices;
+    int rebuilds;
+
+    bool ready;
+
+} TileMapRenderer;
+
+/**
+ * @brief Creates a dinamically allocated TileMapRenderer struct instance.
+ * Needs an OpenGL context.
+ */
+TileMapRenderer* createTileMapRenderer( void );
+
+/**
+ * @brief Destroys a TileMapRenderer object and its GPU resources.
+ */
+void destroyTileMapRenderer( TileMapRenderer *tmr );
+
+/**
+ * @brief Rebuilds the chunk meshes when the tiles changed.
+ */
+void updateTileMapRenderer( TileMapRenderer *tmr, const TileMap *tm );
+
+/**
+ * @brief Draws the chunks that are on the screen.
+ */
+void drawTileMapRenderer( TileMapRenderer *tmr, const TileMap *tm );
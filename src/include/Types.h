@@ -1,18 +1,102 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include "box2d/box2d.h"
 #include "raylib/raylib.h"
+#include "Memory.h"
 
-#define MAX_OBSTACLES 100
-#define MAX_CHAIN_OBSTACLES 100
+#define MAX_OBSTACLES 4096
+#define MAX_CHAIN_OBSTACLES 1024
+// vertices are stored inline in each chain obstacle and its snapshot, so
+// an in-game outline has at most MAX_CHAIN_OBSTACLE_POINTS - 1 vertices
 #define MAX_CHAIN_OBSTACLE_POINTS 50
 
+// room in the level arena for the per level data besides the world
+#define LEVEL_ARENA_EXTRA_CAPACITY ( 256 * 1024 )
+
+#define MAX_LEVELS 8
+
+// tiles of the largest tile map, e.g. 1024 x 256
+#define TILE_MAP_MAX_TILES ( 1024 * 256 )
+
+#define MAX_SPATIAL_QUERIES 256
+#define SPATIAL_QUERY_CACHE_SIZE 512
+#define SPATIAL_QUERY_MAX_THREADS 4
+
+#define MAX_CARVE_REQUESTS 32
+#define CARVE_MAX_VERTICES 32
+#define CARVED_REGION_HISTORY 16
+
+// particle bursts kept for the renderer between two snapshots
+#define PARTICLE_EMITTER_HISTORY 256
+
+// hits kept for the impact audio between two snapshots
+#define IMPACT_HISTORY 256
+
+/**
+ * @brief First member of every entity struct. Bodies store the entity
+ * as user data, so its type can be read from the pointer.
+ */
+typedef enum EntityType {
+    ENTITY_TYPE_PLAYER,
+    ENTITY_TYPE_OBSTACLE,
+    ENTITY_TYPE_CHAIN_OBSTACLE,
+    ENTITY_TYPE_TILE_MAP
+} EntityType;
+
+/**
+ * @brief Behaviour flags of the shapes of an obstacle. The shapes store
+ * the obstacle as user data, so the flags can be read from their ids.
+ */
+typedef enum ShapeFlag {
+    SHAPE_FLAG_NONE = 0,
+
+    // collides only with what comes from above, bodies jump through it
+    // from below and from the sides
+    SHAPE_FLAG_ONE_WAY = 1 << 0
+} ShapeFlag;
+
+typedef struct GameInput {
+
+    bool moveLeft;
+    bool moveRight;
+    bool jump;
+
+    Vector2 mousePosition;
+    bool addChainPoint;
+    bool finishChain;
+    bool cancelChain;
+    bool spawnDynamicObstacle;
+
+    bool toggleDebugInfo;
+    bool toggleParallelQueries;
+    bool togglePhysicsLOD;
+    bool toggleSleep;
+
+    bool reloadLevel;
+    bool nextLevel;
+    bool toggleSolidChains;
+    bool toggleOneWayPlatforms;
+    bool carveTerrain;
+    bool emitParticles;
+
+} GameInput;
+
 typedef struct Player {
 
+    EntityType type;
+
     b2BodyId bodyId;
     b2ShapeId shapeId;
 
+    // render side transform, refreshed from the body move events and
+    // the tick of its last change
+    b2Vec2 position;
+    b2Rot rotation;
+    int changedTick;
+
     Vector2 dim;
     b2Polygon rect;
     Color color;
@@ -24,19 +108,41 @@ typedef struct Player {
     
 } Player;
 
+typedef enum PhysicsLODLevel {
+    PHYSICS_LOD_FULL,
+    PHYSICS_LOD_SLEEPING,
+    PHYSICS_LOD_DISABLED
+} PhysicsLODLevel;
+
 typedef struct Obstacle {
 
+    EntityType type;
+
     b2BodyId bodyId;
     b2ShapeId shapeId;
 
+    // render side transform, refreshed from the body move events and
+    // the tick of its last change
+    b2Vec2 position;
+    b2Rot rotation;
+    int changedTick;
+
     Vector2 dim;
     b2Polygon rect;
     Color color;
 
+    bool dynamic;
+    PhysicsLODLevel lodLevel;
+
+    // ShapeFlag bits
+    unsigned int flags;
+
 } Obstacle;
 
 typedef struct ChainObstacle {
 
+    EntityType type;
+
     b2BodyId bodyId;
     b2ChainId chainId;
 
@@ -46,13 +152,330 @@ typedef struct ChainObstacle {
     Color color;
     bool isConcave;
 
+    // solid obstacles are made of convex polygon shapes instead of a
+    // chain, shapeQuantity counts the polygons or the chain segments
+    bool solid;
+    int shapeQuantity;
+
+    // ShapeFlag bits
+    unsigned int flags;
+
+    int changedTick;
+
 } ChainObstacle;
 
+typedef enum SpatialQueryType {
+    SPATIAL_QUERY_RAY,
+    SPATIAL_QUERY_AABB,
+    SPATIAL_QUERY_SHAPE_CAST
+} SpatialQueryType;
+
+typedef struct SpatialQueryResult {
+
+    bool hit;
+    b2ShapeId shapeId;
+    b2Vec2 point;
+    b2Vec2 normal;
+    float fraction;
+    int overlapQuantity;
+
+} SpatialQueryResult;
+
+typedef struct SpatialQueryKey {
+
+    SpatialQueryType type;
+    int originCellX;
+    int originCellY;
+    int targetCellX;
+    int targetCellY;
+    uint64_t maskBits;
+
+} SpatialQueryKey;
+
+typedef struct SpatialQuery {
+
+    SpatialQueryType type;
+    b2Vec2 origin;
+    b2Vec2 translation;
+    b2AABB aabb;
+    b2ShapeProxy proxy;
+    b2QueryFilter filter;
+
+    SpatialQueryKey key;
+    SpatialQueryResult result;
+    bool pending;
+
+} SpatialQuery;
+
+typedef struct SpatialQueryCacheEntry {
+
+    SpatialQueryKey key;
+    SpatialQueryResult result;
+    int expirationTick;
+    bool used;
+
+} SpatialQueryCacheEntry;
+
+typedef struct SpatialQueryStats {
+
+    int requested;
+    int executed;
+    int cacheHits;
+    int rays;
+    int aabbs;
+    int shapeCasts;
+    int threadsUsed;
+    b2TreeStats treeStats;
+    double executionTime;
+
+} SpatialQueryStats;
+
+typedef struct SpatialQueryWorkerPool SpatialQueryWorkerPool;
+
+typedef struct SpatialQueryService {
+
+    SpatialQuery queries[MAX_SPATIAL_QUERIES];
+    int queryQuantity;
+
+    SpatialQueryCacheEntry cache[SPATIAL_QUERY_CACHE_SIZE];
+    float cacheCellSize;
+    int cacheTicks;
+    int tick;
+
+    bool parallel;
+    int parallelThreshold;
+
+    // threads of the parallel batches, started with the first one and
+    // kept until the service is destroyed (NULL before that)
+    SpatialQueryWorkerPool *workers;
+
+    SpatialQueryStats stats;
+
+} SpatialQueryService;
+
+typedef struct PhysicsLOD {
+
+    bool enabled;
+
+    // dynamic bodies farther than sleepRadius from the focus are kept
+    // asleep and the ones farther than disableRadius are removed from
+    // the simulation; hysteresis avoids flapping at the ring borders
+    float sleepRadius;
+    float disableRadius;
+    float hysteresis;
+
+    // bodies evaluated per tick, amortizing the cost on large levels
+    int budget;
+    int cursor;
+
+    int fullQuantity;
+    int sleepingQuantity;
+    int disabledQuantity;
+    int transitions;
+
+} PhysicsLOD;
+
+typedef struct SleepManager {
+
+    bool enableSleep;
+
+    // per entity type sleep speed thresholds
+    float playerSleepThreshold;
+    float dynamicObstacleSleepThreshold;
+
+    // bodies outside the active region that are below their sleep
+    // threshold are forced to sleep and sleeping bodies closer than
+    // wakeRadius to the focus are woken up
+    Rectangle activeRegion;
+    float wakeRadius;
+
+    int budget;
+    int cursor;
+
+    int forcedSleeps;
+    int proximityWakes;
+    int awakeBodies;
+    int sleepingBodies;
+    int islands;
+
+} SleepManager;
+
+typedef struct OneWayPlatformStats {
+
+    bool enabled;
+    int platformShapes;
+
+    // of the last step
+    int preSolveCalls;
+    int disabledContacts;
+    float collideTime;
+
+} OneWayPlatformStats;
+
+/**
+ * @brief Settings and counters of the presolve callback that makes the
+ * one way platforms. The counters are incremented by the solver threads
+ * and collected after each step.
+ */
+typedef struct OneWayPlatforms {
+
+    // smallest upward component of the contact normal that is kept and
+    // deepest penetration still resolved, larger ones mean the body is
+    // passing through from below
+    float minNormal;
+    float maxPenetration;
+
+    atomic_int preSolveCalls;
+    atomic_int disabledContacts;
+
+    OneWayPlatformStats stats;
+
+} OneWayPlatforms;
+
+/**
+ * @brief A polygon to be subtracted from the chain obstacles it overlaps.
+ * Only the chains that existed when the carve started are visited, the
+ * pieces it creates are appended after chainEnd.
+ */
+typedef struct CarveRequest {
+
+    b2Vec2 points[CARVE_MAX_VERTICES];
+    int pointQuantity;
+    b2AABB bounds;
+
+    bool started;
+    int chainCursor;
+    int chainEnd;
+
+} CarveRequest;
+
+typedef struct TerrainCarver {
+
+    // ring of pending requests
+    CarveRequest requests[MAX_CARVE_REQUESTS];
+    int first;
+    int quantity;
+
+    // chain obstacles subtracted per tick, large carves take a few ticks
+    int budget;
+
+    // bounds of the geometry changed by the last ticks that carved, so
+    // the renderer repaints only them; regionTotal only grows
+    b2AABB regions[CARVED_REGION_HISTORY];
+    int regionTotal;
+
+    int carvedChains;
+    int removedChains;
+    int createdChains;
+    int skippedHoles;
+    int totalCarves;
+    float carveTime;
+
+} TerrainCarver;
+
+/**
+ * @brief A burst of particles requested by the simulation, e.g. where two
+ * shapes hit each other. The particles themselves live in the renderer.
+ */
+typedef struct ParticleEmitter {
+    b2Vec2 position;
+    b2Vec2 direction;
+    float speed;
+    int quantity;
+    Color color;
+} ParticleEmitter;
+
+/**
+ * @brief A hit between two bodies, reported by Box2D when a shape with
+ * hit events approached another one faster than the threshold.
+ */
+typedef struct ImpactEvent {
+    b2Vec2 position;
+    float speed;
+
+    // identifies the pair of bodies, whatever their order
+    uint64_t pairKey;
+} ImpactEvent;
+
+/**
+ * @brief Parameters of a generated scene. The same seed always generates
+ * the same scene.
+ */
+typedef struct StressSceneConfig {
+    int boxObstacles;
+    int chainObstacles;
+    int chainVertices;
+    int dynamicBodies;
+    unsigned int seed;
+} StressSceneConfig;
+
+/**
+ * @brief Source of a tile map: a text grid file or, without one, a
+ * generated terrain of columns x rows tiles. A tileSize of zero fits the
+ * map into the walled area.
+ */
+typedef struct TileMapConfig {
+    const char *fileName;
+    int columns;
+    int rows;
+    float tileSize;
+    unsigned int seed;
+
+    // simple regions become chain obstacles instead of rectangles
+    bool outlineChains;
+} TileMapConfig;
+
+/**
+ * @brief Grid of tiles, 0 for empty and the tile kind otherwise. The
+ * solid tiles are merged into a few large colliders of a single static
+ * body.
+ */
+typedef struct TileMap {
+
+    EntityType type;
+
+    b2BodyId bodyId;
+
+    b2Vec2 origin;
+    float tileSize;
+    int columns;
+    int rows;
+    unsigned char tiles[TILE_MAP_MAX_TILES];
+
+    bool loaded;
+
+    // incremented whenever the tiles change, so the cached meshes of
+    // the renderer and the snapshot copies can be refreshed
+    int revision;
+
+    int solidTiles;
+    int rectangleQuantity;
+    int chainQuantity;
+    float buildTime;
+
+} TileMap;
+
+/**
+ * @brief What a level contains besides the player and the walls.
+ */
+typedef struct LevelDef {
+    const char *name;
+    bool dummyObstacles;
+    bool stressScene;
+    StressSceneConfig stressSceneConfig;
+    bool tileMap;
+    TileMapConfig tileMapConfig;
+} LevelDef;
+
 typedef struct GameWorld {
 
     b2WorldDef worldDef;
     b2WorldId worldId;
 
+    // size of the walled area
+    float width;
+    float height;
+
     Player player;
 
     Obstacle obstacles[MAX_OBSTACLES];
@@ -61,5 +484,108 @@ typedef struct GameWorld {
     ChainObstacle chainObstacles[MAX_CHAIN_OBSTACLES];
     int chainObstacleQuantity;
 
+    TileMap tileMap;
+
+    PhysicsLOD lod;
+    SleepManager sleep;
+    TerrainCarver carver;
+    OneWayPlatforms oneWayPlatforms;
+
+    SpatialQueryService queryService;
+    int lineOfSightQuery;
+    b2Vec2 lineOfSightTarget;
+
+    bool showDebugInfo;
+
+    int tick;
+    int refreshedTransforms;
+
+    // incremented whenever static geometry is added, removed or reshaped
+    int staticRevision;
+
+    // milliseconds of the last b2World_Step, from the Box2D profile
+    float stepTime;
+
+    // per level allocations, released when the world is destroyed
+    MemoryArena *levelArena;
+
+    // chain obstacles created as convex polygons instead of chains
+    bool solidChainObstacles;
+
+    // ring of the particle bursts; particleEmitterTotal only grows
+    ParticleEmitter particleEmitters[PARTICLE_EMITTER_HISTORY];
+    int particleEmitterTotal;
+
+    // ring of the hits for the impact audio; impactTotal only grows
+    ImpactEvent impacts[IMPACT_HISTORY];
+    int impactTotal;
+
+    LevelDef levels[MAX_LEVELS];
+    int levelQuantity;
+    int currentLevel;
+    bool levelLoaded;
+
+    // milliseconds of the last level load and unload
+    float levelLoadTime;
+    float levelUnloadTime;
+
 } GameWorld;
 
+/**
+ * @brief Copy of the render relevant state of a GameWorld, so it can be
+ * drawn without touching the Box2D world.
+ */
+typedef struct RenderSnapshot {
+
+    Player player;
+
+    Obstacle obstacles[MAX_OBSTACLES];
+    int obstaclesQuantity;
+
+    ChainObstacle chainObstacles[MAX_CHAIN_OBSTACLES];
+    int chainObstacleQuantity;
+
+    // the tiles are only copied when the revision changes
+    TileMap tileMap;
+
+    b2Vec2 creationPoints[MAX_CHAIN_OBSTACLE_POINTS];
+    int creationPointsQ;
+
+    bool showDebugInfo;
+    int staticRevision;
+    bool lineOfSightValid;
+    bool lineOfSightHit;
+    b2Vec2 lineOfSightOrigin;
+    b2Vec2 lineOfSightEnd;
+
+    SpatialQueryStats queryStats;
+    PhysicsLOD lod;
+    SleepManager sleep;
+    TerrainCarver carver;
+    OneWayPlatformStats oneWayPlatforms;
+
+    // only the bursts emitted since the last capture are copied
+    ParticleEmitter particleEmitters[PARTICLE_EMITTER_HISTORY];
+    int particleEmitterTotal;
+
+    // only the hits since the last capture are copied
+    ImpactEvent impacts[IMPACT_HISTORY];
+    int impactTotal;
+
+    bool pipelined;
+    double updateTime;
+    float stepTime;
+
+    const char *levelName;
+    bool solidChainObstacles;
+    float levelLoadTime;
+    float levelUnloadTime;
+
+    // tick of the last capture into this snapshot (-1 when never
+    // captured), entities that didn't change since then aren't copied
+    int capturedTick;
+    int refreshedTransforms;
+    int copiedEntities;
+
+} RenderSnapshot;
+
@@ -4,15 +4,91 @@
  * @brief Main function and logic for the game. Base template for game
  * development in C using Raylib (https://www.raylib.com/).
  * 
+ * Stress scenes, for scaling tests:
+ *    -stress <boxes> <chains> <chainVertices> <dynamicBodies> <seed>
+ *        adds a generated scene to the world
+ *    -report <file>
+ *        appends the average timings to a CSV file (stress.csv)
+ *    -headless <steps> <frames>
+ *        runs without a window, scaling the stress scene quantities
+ *        from 1 to steps times, frames fixed steps each, with hollow
+ *        and with solid chain obstacles
+ * 
+ * Tile maps:
+ *    -tilemap <file>
+ *        starts with a level imported from a text grid
+ *    -tiles <columns> <rows> <seed>
+ *        starts with a generated level of columns x rows tiles
+ * 
+ * Music:
+ *    -music <file>
+ *        streams a music file from the audio thread (toggled with M)
+ * 
  * @copyright Copyright (c) 2025
  */
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "GameWindow.h"
+#include "StressScene.h"
+#include "Memory.h"
+
+int main( int argc, char **argv ) {
+
+    bool stress = false;
+    StressSceneConfig config = { 100, 50, 16, 200, 1 };
+    const char *reportFileName = NULL;
+    bool headless = false;
+    int steps = 8;
+    int frames = 300;
+    bool tiles = false;
+    TileMapConfig tileMap = { NULL, 95, 51, 8.0f, 1, true };
+    const char *musicFileName = NULL;
 
-int main( void ) {
+    // before any Box2D world, so every Box2D allocation is tracked
+    initMemory( MEMORY_FRAME_SCRATCH_CAPACITY );
+
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "-stress" ) == 0 && i + 5 < argc ) {
+            stress = true;
+            config.boxObstacles = atoi( argv[++i] );
+            config.chainObstacles = atoi( argv[++i] );
+            config.chainVertices = atoi( argv[++i] );
+            config.dynamicBodies = atoi( argv[++i] );
+            config.seed = (unsigned int) strtoul( argv[++i], NULL, 10 );
+        } else if ( strcmp( argv[i], "-report" ) == 0 && i + 1 < argc ) {
+            reportFileName = argv[++i];
+        } else if ( strcmp( argv[i], "-headless" ) == 0 && i + 2 < argc ) {
+            headless = true;
+            steps = atoi( argv[++i] );
+            frames = atoi( argv[++i] );
+        } else if ( strcmp( argv[i], "-tilemap" ) == 0 && i + 1 < argc ) {
+            tiles = true;
+            tileMap.fileName = argv[++i];
+            tileMap.tileSize = 0.0f;
+        } else if ( strcmp( argv[i], "-tiles" ) == 0 && i + 3 < argc ) {
+            tiles = true;
+            tileMap.columns = atoi( argv[++i] );
+            tileMap.rows = atoi( argv[++i] );
+            tileMap.seed = (unsigned int) strtoul( argv[++i], NULL, 10 );
+            tileMap.tileSize = 0.0f;
+        } else if ( strcmp( argv[i], "-music" ) == 0 && i + 1 < argc ) {
+            musicFileName = argv[++i];
+        } else {
+            fprintf( stderr, "unknown option %s\n", argv[i] );
+            return 1;
+        }
+    }
+
+    if ( headless ) {
+        runHeadlessStressTest( 
+            &config, steps > 0 ? steps : 1, frames > 0 ? frames : 1, 
+            reportFileName != NULL ? reportFileName : "stress.csv" 
+        );
+        return 0;
+    }
 
     GameWindow *gameWindow = createGameWindow(
         800,                 // width
@@ -26,11 +102,23 @@ int main( void ) {
         false,               // always on top
         false,               // always run
         false,               // load resources
-        false                // init audio
+        true                 // init audio
     );
 
+    if ( stress ) {
+        setGameWindowStressScene( gameWindow, &config, reportFileName );
+    }
+
+    if ( tiles ) {
+        setGameWindowTileMap( gameWindow, &tileMap );
+    }
+
+    if ( musicFileName != NULL ) {
+        setGameWindowMusic( gameWindow, musicFileName );
+    }
+
     initGameWindow( gameWindow );
 
     return 0;
 
-}
\ No newline at end of file
+}